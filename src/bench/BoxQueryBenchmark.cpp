@@ -0,0 +1,79 @@
+#include <iostream>
+
+#include "../core/World.h"
+#include "../util/TextUtil.h"
+#include "../util/TimeManager.h"
+
+// a box around the origin, as wide as given and tall enough to hold the whole startup terrain
+struct QueryBox {
+    glm::ivec3 minPos;
+    glm::ivec3 maxPos;
+};
+
+static QueryBox getQueryBox(const int width) {
+    return {{-width / 2, -8, -width / 2}, {width / 2 - 1, 31, width / 2 - 1}};
+}
+
+// what callers had to do before ChunkManager::visitRegion: look up every position in the box on its own
+static uint64_t countByPosition(ChunkManager &chunkManager, const QueryBox &box, uint64_t &colorSum) {
+    uint64_t blockCount = 0;
+    for (int z = box.minPos.z; z <= box.maxPos.z; z++) {
+        for (int y = box.minPos.y; y <= box.maxPos.y; y++) {
+            for (int x = box.minPos.x; x <= box.maxPos.x; x++) {
+                const glm::vec3 position(x, y, z);
+                if (chunkManager.hasBlock(position)) {
+                    colorSum += chunkManager.getBlock(position).color[1];
+                    blockCount++;
+                }
+            }
+        }
+    }
+    return blockCount;
+}
+
+static uint64_t countByRegion(const ChunkManager &chunkManager, const QueryBox &box, uint64_t &colorSum) {
+    uint64_t blockCount = 0;
+    chunkManager.visitRegion(box.minPos, box.maxPos, [&](const RegionRun &run) {
+        colorSum += static_cast<uint64_t>(MaterialRegistry::getMaterial(run.material).color[1]) * run.length;
+        blockCount += run.length;
+    });
+    return blockCount;
+}
+
+// generates the startup terrain, then finds every block in boxes of growing size around the origin, once by looking
+// up each position and once with visitRegion. reports the time of both and whether they found the same blocks
+int main() {
+    try {
+        World world;
+        world.init();
+        ChunkManager &chunkManager = world.getChunkManager();
+
+        for (const int width: {16, 64, 256, 1024, 2048}) {
+            const QueryBox box = getQueryBox(width);
+
+            uint64_t positionColorSum = 0;
+            TimeManager::startTimer("countByPosition");
+            const uint64_t positionCount = countByPosition(chunkManager, box, positionColorSum);
+            const float positionTime = TimeManager::finishTimer("countByPosition");
+
+            uint64_t regionColorSum = 0;
+            TimeManager::startTimer("countByRegion");
+            const uint64_t regionCount = countByRegion(chunkManager, box, regionColorSum);
+            const float regionTime = TimeManager::finishTimer("countByRegion");
+
+            std::cout << width << "x40x" << width << " box: " << TextUtil::getCommaString(regionCount) <<
+                    " blocks, " << (positionCount == regionCount && positionColorSum == regionColorSum
+                                        ? "same blocks"
+                                        : "DIFFERENT blocks") << "\n";
+            std::cout << "    by position: " << positionTime * 1000 << " ms, visitRegion: " << regionTime * 1000 <<
+                    " ms, " << positionTime / regionTime << "x\n";
+        }
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <string>
+
+#include "../core/World.h"
+#include "../util/TextUtil.h"
+#include "../util/TimeManager.h"
+
+struct BenchmarkBrush {
+    std::string name;
+    Brush brush;
+};
+
+static uint64_t countBlocks(const ChunkManager &chunkManager, const Brush &brush) {
+    uint64_t blockCount = 0;
+    chunkManager.visitRegion(brush.getMinBlock(), brush.getMaxBlock(), [&](const RegionRun &run) {
+        blockCount += run.length;
+    });
+    return blockCount;
+}
+
+// what callers had to do before fillBrush and clearBrush: add or remove every block inside the brush on its own
+static void fillByBlock(ChunkManager &chunkManager, const Brush &brush, const Block &block) {
+    const glm::ivec3 minBlock = brush.getMinBlock();
+    const glm::ivec3 maxBlock = brush.getMaxBlock();
+    for (int z = minBlock.z; z <= maxBlock.z; z++) {
+        for (int y = minBlock.y; y <= maxBlock.y; y++) {
+            for (int x = minBlock.x; x <= maxBlock.x; x++) {
+                if (brush.contains({x, y, z})) {
+                    Block newBlock = block;
+                    newBlock.position = glm::vec3(x, y, z);
+                    chunkManager.addBlock(newBlock);
+                }
+            }
+        }
+    }
+}
+
+static void clearByBlock(ChunkManager &chunkManager, const Brush &brush) {
+    const glm::ivec3 minBlock = brush.getMinBlock();
+    const glm::ivec3 maxBlock = brush.getMaxBlock();
+    for (int z = minBlock.z; z <= maxBlock.z; z++) {
+        for (int y = minBlock.y; y <= maxBlock.y; y++) {
+            for (int x = minBlock.x; x <= maxBlock.x; x++) {
+                const glm::vec3 position(x, y, z);
+                if (brush.contains({x, y, z}) && chunkManager.hasBlock(position)) {
+                    chunkManager.removeBlock(position);
+                }
+            }
+        }
+    }
+}
+
+static float timeMeshing(ChunkManager &chunkManager) {
+    TimeManager::startTimer("brushMeshing");
+    chunkManager.meshAllChunks();
+    return TimeManager::finishTimer("brushMeshing");
+}
+
+// generates the startup terrain, then fills and clears brushes of growing size that cut into it, once block by block
+// and once with fillBrush and clearBrush. reports the time of both, the time to remesh afterwards, and whether they
+// left the same blocks behind
+int main() {
+    try {
+        World world;
+        world.init();
+        ChunkManager &chunkManager = world.getChunkManager();
+
+        Block block{};
+        Block::setColor(block, 200, 60, 40);
+
+        for (const int size: {8, 32, 64}) {
+            const float radius = static_cast<float>(size);
+            const std::vector<BenchmarkBrush> brushes = {
+                {"box", Brush::box(glm::ivec3(-size), glm::ivec3(size - 1))},
+                {"sphere", Brush::sphere(glm::vec3(0.0f), radius)},
+                {"cylinder", Brush::cylinder(glm::vec3(0.0f, -radius, 0.0f), radius, radius * 2.0f)}
+            };
+
+            for (const auto &[name, brush]: brushes) {
+                TimeManager::startTimer("fillByBlock");
+                fillByBlock(chunkManager, brush, block);
+                const float fillBlockTime = TimeManager::finishTimer("fillByBlock");
+                const float fillBlockMeshTime = timeMeshing(chunkManager);
+                const uint64_t filledByBlock = countBlocks(chunkManager, brush);
+
+                TimeManager::startTimer("clearByBlock");
+                clearByBlock(chunkManager, brush);
+                const float clearBlockTime = TimeManager::finishTimer("clearByBlock");
+                const float clearBlockMeshTime = timeMeshing(chunkManager);
+                const uint64_t clearedByBlock = countBlocks(chunkManager, brush);
+
+                TimeManager::startTimer("fillBrush");
+                chunkManager.fillBrush(brush, block.color);
+                const float fillBrushTime = TimeManager::finishTimer("fillBrush");
+                const float fillBrushMeshTime = timeMeshing(chunkManager);
+                const uint64_t filledByBrush = countBlocks(chunkManager, brush);
+
+                TimeManager::startTimer("clearBrush");
+                chunkManager.clearBrush(brush);
+                const float clearBrushTime = TimeManager::finishTimer("clearBrush");
+                const float clearBrushMeshTime = timeMeshing(chunkManager);
+                const uint64_t clearedByBrush = countBlocks(chunkManager, brush);
+
+                std::cout << name << " of size " << size << ": " << TextUtil::getCommaString(filledByBrush) <<
+                        " blocks, " << (filledByBlock == filledByBrush && clearedByBlock == clearedByBrush
+                                            ? "same blocks"
+                                            : "DIFFERENT blocks") << "\n";
+                std::cout << "    fill by block: " << fillBlockTime * 1000 << " ms, fillBrush: " <<
+                        fillBrushTime * 1000 << " ms, " << fillBlockTime / fillBrushTime << "x, remeshing: " <<
+                        fillBlockMeshTime * 1000 << " ms and " << fillBrushMeshTime * 1000 << " ms\n";
+                std::cout << "    clear by block: " << clearBlockTime * 1000 << " ms, clearBrush: " <<
+                        clearBrushTime * 1000 << " ms, " << clearBlockTime / clearBrushTime << "x, remeshing: " <<
+                        clearBlockMeshTime * 1000 << " ms and " << clearBrushMeshTime * 1000 << " ms\n";
+            }
+        }
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,40 @@
+#include <iostream>
+
+#include "../core/World.h"
+#include "../rendering/scene/VertexPool.h"
+#include "../util/TextUtil.h"
+
+// generates and meshes the same terrain as the main executable without opening a window,
+// build the chunk_size_benchmark_<edge> targets and compare their output to pick a chunk size
+int main() {
+    try {
+        std::cout << "Chunk size: " << CHUNK_EDGE << "x" << CHUNK_EDGE << "x" << CHUNK_EDGE << "\n";
+
+        World world;
+        world.init();
+
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        for (const auto &[chunkID, memoryRange]: VertexPool::getOccupiedVertexRanges()) {
+            vertexCount += memoryRange.objectCount;
+        }
+        for (const auto &[chunkID, memoryRange]: VertexPool::getOccupiedIndexRanges()) {
+            indexCount += memoryRange.objectCount;
+        }
+
+        std::cout << "Meshes: " << TextUtil::getCommaString(vertexCount) << " vertices, " <<
+                TextUtil::getCommaString(indexCount) << " indices, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(VertexPool::getOccupiedIndexRanges().size())) <<
+                " draws\n";
+        std::cout << "Vertex pool: " << TextUtil::getCommaString(static_cast<uint32_t>(globalChunkVertices.size())) <<
+                " vertices, " << TextUtil::getCommaString(static_cast<uint32_t>(globalChunkIndices.size())) <<
+                " indices reserved\n";
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+#include <array>
+#include <iostream>
+
+#include "../core/World.h"
+#include "../util/TextUtil.h"
+#include "../util/TimeManager.h"
+
+struct MeshTotals {
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    std::array<uint32_t, MAX_LOD_LEVEL + 1> lodChunkCounts{};
+};
+
+static MeshTotals getMeshTotals(const ChunkManager &chunkManager) {
+    MeshTotals totals;
+    for (const auto &[chunkCoords, chunk]: chunkManager.chunks) {
+        totals.vertexCount += chunk.vertices.size();
+        totals.indexCount += chunk.indices.size();
+        totals.lodChunkCounts[chunk.lodLevel]++;
+    }
+    return totals;
+}
+
+// generates and meshes the startup terrain at full resolution, then picks the levels of detail for a camera above
+// the middle of the map with growing LOD distances. reports how long remeshing the changed chunks took and how many
+// vertices and indices the meshes have compared to full resolution
+int main() {
+    try {
+        World world;
+        world.init();
+        ChunkManager &chunkManager = world.getChunkManager();
+        const glm::vec3 cameraPosition(0.0f, 20.0f, 0.0f);
+
+        const MeshTotals fullTotals = getMeshTotals(chunkManager);
+        std::cout << "full resolution: " << TextUtil::getCommaString(fullTotals.vertexCount) << " vertices, " <<
+                TextUtil::getCommaString(fullTotals.indexCount) << " indices\n";
+
+        for (const float lodDistance: {256.0f, 128.0f, 64.0f, 32.0f}) {
+            chunkManager.setLodDistance(lodDistance);
+            chunkManager.updateLodLevels(cameraPosition);
+            TimeManager::startTimer("lodMeshing");
+            chunkManager.meshAllChunks();
+            const float meshingTime = TimeManager::finishTimer("lodMeshing");
+
+            const MeshTotals totals = getMeshTotals(chunkManager);
+            std::cout << "LOD distance " << lodDistance << ": " << TextUtil::getCommaString(totals.vertexCount) <<
+                    " vertices, " << TextUtil::getCommaString(totals.indexCount) << " indices, " <<
+                    static_cast<float>(fullTotals.vertexCount) / static_cast<float>(totals.vertexCount) <<
+                    "x fewer vertices, remeshed in " << meshingTime * 1000 << " ms\n";
+            std::cout << "    chunks per level:";
+            for (const uint32_t chunkCount: totals.lodChunkCounts) {
+                std::cout << " " << TextUtil::getCommaString(chunkCount);
+            }
+            std::cout << "\n";
+        }
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <iostream>
+
+#include "../core/World.h"
+#include "../util/ThreadPool.h"
+#include "../util/TimeManager.h"
+
+// generates the startup terrain once, then marks every chunk as modified and remeshes it with an increasing
+// number of threads. the vertex pool commit stays on the main thread and is included in the times
+int main() {
+    try {
+        World world;
+        world.init();
+        ChunkManager &chunkManager = world.getChunkManager();
+
+        const unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        float singleThreadTime = 0;
+
+        for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+            ThreadPool::setThreadCount(threadCount);
+
+            for (auto &[coords, chunk]: chunkManager.chunks) {
+                chunkManager.markChunkDirty(chunk);
+            }
+
+            TimeManager::startTimer("meshingBenchmark");
+            chunkManager.meshAllChunks();
+            const float meshingTime = TimeManager::finishTimer("meshingBenchmark");
+
+            if (threadCount == 1) {
+                singleThreadTime = meshingTime;
+            }
+            std::cout << threadCount << " threads: " << meshingTime * 1000 << " ms, " <<
+                    singleThreadTime / meshingTime << "x\n";
+
+            if (threadCount < maxThreads && threadCount * 2 > maxThreads) {
+                threadCount = maxThreads / 2;
+            }
+        }
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "../core/ChunkGeometry.h"
+#include "../util/NoiseBatch.h"
+#include "../util/TextUtil.h"
+#include "../util/TimeManager.h"
+
+// same area, seed and frequency as the startup terrain, sampled one chunk-column tile at a time
+constexpr int TERRAIN_RANGE = 1000;
+constexpr int NOISE_SEED = 1337;
+constexpr float NOISE_FREQUENCY = 0.01f;
+constexpr int REPEATS = 10;
+
+static void printSamplesPerSecond(const std::string &name, const float time) {
+    const auto sampleCount = static_cast<uint64_t>(TERRAIN_RANGE) * TERRAIN_RANGE * REPEATS;
+    std::cout << name << ": " << time * 1000 << " ms, " <<
+            TextUtil::getCommaString(static_cast<uint32_t>(sampleCount / time)) << " samples/sec\n";
+}
+
+int main() {
+    try {
+        FastNoiseLite noise;
+        noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+        noise.SetSeed(NOISE_SEED);
+        noise.SetFrequency(NOISE_FREQUENCY);
+        const NoiseBatch noiseBatch(NOISE_SEED, NOISE_FREQUENCY);
+
+        std::vector<float> scalarSamples(TERRAIN_RANGE * TERRAIN_RANGE);
+        std::vector<float> batchSamples(TERRAIN_RANGE * TERRAIN_RANGE);
+        std::vector<float> tileSamples(CHUNK_EDGE * CHUNK_EDGE);
+        constexpr int halfRange = TERRAIN_RANGE / 2;
+
+        TimeManager::startTimer("scalarNoise");
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            for (int z = 0; z < TERRAIN_RANGE; z++) {
+                for (int x = 0; x < TERRAIN_RANGE; x++) {
+                    scalarSamples[z * TERRAIN_RANGE + x] = noise.GetNoise(static_cast<float>(x - halfRange),
+                                                                          static_cast<float>(z - halfRange));
+                }
+            }
+        }
+        printSamplesPerSecond("GetNoise", TimeManager::finishTimer("scalarNoise"));
+
+        TimeManager::startTimer("batchedNoise");
+        for (int repeat = 0; repeat < REPEATS; repeat++) {
+            for (int tileZ = 0; tileZ < TERRAIN_RANGE; tileZ += CHUNK_EDGE) {
+                for (int tileX = 0; tileX < TERRAIN_RANGE; tileX += CHUNK_EDGE) {
+                    const int width = std::min(CHUNK_EDGE, TERRAIN_RANGE - tileX);
+                    const int depth = std::min(CHUNK_EDGE, TERRAIN_RANGE - tileZ);
+                    noiseBatch.sampleGrid(tileX - halfRange, tileZ - halfRange, width, depth, tileSamples.data());
+
+                    for (int z = 0; z < depth; z++) {
+                        std::memcpy(&batchSamples[(tileZ + z) * TERRAIN_RANGE + tileX], &tileSamples[z * width],
+                                    width * sizeof(float));
+                    }
+                }
+            }
+        }
+        printSamplesPerSecond("NoiseBatch", TimeManager::finishTimer("batchedNoise"));
+
+        uint32_t mismatches = 0;
+        for (size_t i = 0; i < scalarSamples.size(); i++) {
+            mismatches += std::memcmp(&scalarSamples[i], &batchSamples[i], sizeof(float)) != 0;
+        }
+        std::cout << TextUtil::getCommaString(mismatches) << " samples differ, probe check " <<
+                (noiseBatch.matches(noise) ? "passed" : "failed") << "\n";
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <optional>
+#include <random>
+
+#include "../core/World.h"
+#include "../util/TextUtil.h"
+#include "../util/ThreadPool.h"
+#include "../util/TimeManager.h"
+
+static constexpr int RAY_COUNT = 100000;
+static constexpr float MAX_RAY_DISTANCE = 256.0f;
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+// what callers had to do before ChunkManager::raycast: visit every block along the ray and look each one up
+// block p spans p - 0.5 to p + 0.5, so the walk is shifted half a block to put its boundaries on integers
+static std::optional<glm::ivec3> raycastByBlock(ChunkManager &chunkManager, const Ray &ray) {
+    const glm::vec3 direction = glm::normalize(ray.direction);
+    const glm::vec3 origin = ray.origin + 0.5f;
+    glm::ivec3 blockPos = glm::ivec3(glm::floor(origin));
+    glm::ivec3 step(0);
+    glm::vec3 nextBoundary(std::numeric_limits<float>::infinity());
+    glm::vec3 boundaryStep(std::numeric_limits<float>::infinity());
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (direction[axis] > 0.0f) {
+            step[axis] = 1;
+            nextBoundary[axis] = (static_cast<float>(blockPos[axis] + 1) - origin[axis]) / direction[axis];
+            boundaryStep[axis] = 1.0f / direction[axis];
+        }
+        else if (direction[axis] < 0.0f) {
+            step[axis] = -1;
+            nextBoundary[axis] = (static_cast<float>(blockPos[axis]) - origin[axis]) / direction[axis];
+            boundaryStep[axis] = -1.0f / direction[axis];
+        }
+    }
+
+    float distance = 0.0f;
+    while (distance <= MAX_RAY_DISTANCE) {
+        if (chunkManager.hasBlock(glm::vec3(blockPos))) {
+            return blockPos;
+        }
+
+        int axis = 0;
+        for (int i = 1; i < 3; i++) {
+            if (nextBoundary[i] < nextBoundary[axis]) {
+                axis = i;
+            }
+        }
+        distance = nextBoundary[axis];
+        blockPos[axis] += step[axis];
+        nextBoundary[axis] += boundaryStep[axis];
+    }
+
+    return std::nullopt;
+}
+
+// generates the startup terrain, then casts the same rays from above it block by block with hasBlock and with
+// ChunkManager::raycast, on one thread and then on the thread pool. reports rays/sec for each and how many of
+// the hits agree, rays that pass exactly through an edge may pick either block
+int main() {
+    try {
+        World world;
+        world.init();
+        ChunkManager &chunkManager = world.getChunkManager();
+
+        // a mix of rays looking down at the terrain, along it and up into the empty sky
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+        std::uniform_real_distribution<float> height(5.0f, 60.0f);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        std::vector<Ray> rays(RAY_COUNT);
+        for (Ray &ray: rays) {
+            ray.origin = glm::vec3(position(random), height(random), position(random));
+            do {
+                ray.direction = glm::vec3(direction(random), direction(random), direction(random));
+            } while (glm::length(ray.direction) < 0.01f);
+        }
+
+        std::vector<std::optional<glm::ivec3>> blockHits(rays.size());
+        TimeManager::startTimer("raycastByBlock");
+        for (size_t i = 0; i < rays.size(); i++) {
+            blockHits[i] = raycastByBlock(chunkManager, rays[i]);
+        }
+        const float blockTime = TimeManager::finishTimer("raycastByBlock");
+
+        std::vector<std::optional<RaycastHit>> hits(rays.size());
+        TimeManager::startTimer("raycast");
+        for (size_t i = 0; i < rays.size(); i++) {
+            hits[i] = chunkManager.raycast(rays[i].origin, rays[i].direction, MAX_RAY_DISTANCE);
+        }
+        const float raycastTime = TimeManager::finishTimer("raycast");
+
+        TimeManager::startTimer("parallelRaycast");
+        ThreadPool::parallelFor(rays.size(), [&](const size_t i) {
+            hits[i] = chunkManager.raycast(rays[i].origin, rays[i].direction, MAX_RAY_DISTANCE);
+        });
+        const float parallelTime = TimeManager::finishTimer("parallelRaycast");
+
+        uint32_t hitCount = 0;
+        uint32_t matchingCount = 0;
+        for (size_t i = 0; i < rays.size(); i++) {
+            hitCount += hits[i].has_value();
+            if (hits[i].has_value() == blockHits[i].has_value() &&
+                (!hits[i].has_value() || hits[i]->blockPos == *blockHits[i])) {
+                matchingCount++;
+            }
+        }
+
+        std::cout << TextUtil::getCommaString(static_cast<uint32_t>(rays.size())) << " rays up to " <<
+                MAX_RAY_DISTANCE << " blocks, " << TextUtil::getCommaString(hitCount) << " hits, " <<
+                TextUtil::getCommaString(matchingCount) << " agree with the block by block walk\n";
+        std::cout << "block by block: " << blockTime * 1000 << " ms, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(rays.size() / blockTime)) << " rays/sec\n";
+        std::cout << "raycast: " << raycastTime * 1000 << " ms, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(rays.size() / raycastTime)) << " rays/sec, " <<
+                blockTime / raycastTime << "x\n";
+        std::cout << "raycast on " << ThreadPool::getThreadCount() << " threads: " << parallelTime * 1000 << " ms, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(rays.size() / parallelTime)) << " rays/sec\n";
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+#include <filesystem>
+#include <iostream>
+#include <unordered_set>
+
+#include "../core/RegionStore.h"
+#include "../core/World.h"
+#include "../util/TextUtil.h"
+#include "../util/TimeManager.h"
+
+// written next to the binary and removed again afterwards
+static const std::filesystem::path BENCHMARK_DIRECTORY = "region_benchmark";
+
+static uint64_t getDirectorySize(const std::filesystem::path &directory) {
+    uint64_t size = 0;
+    for (const auto &entry: std::filesystem::directory_iterator(directory)) {
+        size += entry.file_size();
+    }
+    return size;
+}
+
+// generates the startup terrain, saves every column of it to region files, then loads every column back through a
+// fresh store so each region is mapped again. reports columns/sec and blocks/sec for both, and the size on disk
+int main() {
+    try {
+        World world;
+        world.init();
+        ChunkManager &chunkManager = world.getChunkManager();
+
+        std::unordered_set<glm::ivec2> columnSet;
+        for (const auto &[chunkCoords, chunk]: chunkManager.chunks) {
+            columnSet.insert({chunkCoords.x, chunkCoords.z});
+        }
+        const std::vector<glm::ivec2> columns(columnSet.begin(), columnSet.end());
+
+        std::filesystem::remove_all(BENCHMARK_DIRECTORY);
+
+        TimeManager::startTimer("saveRegions");
+        RegionStore(BENCHMARK_DIRECTORY).saveColumns(chunkManager, columns);
+        const float saveTime = TimeManager::finishTimer("saveRegions");
+
+        RegionStore regionStore(BENCHMARK_DIRECTORY);
+        std::vector<Block> blocks;
+        uint64_t blockCount = 0;
+        TimeManager::startTimer("loadRegions");
+        for (const glm::ivec2 &column: columns) {
+            blocks.clear();
+            if (!regionStore.loadColumn(column, blocks)) {
+                throw std::runtime_error("region benchmark error: a saved column is missing!");
+            }
+            blockCount += blocks.size();
+        }
+        const float loadTime = TimeManager::finishTimer("loadRegions");
+
+        const uint64_t fileSize = getDirectorySize(BENCHMARK_DIRECTORY);
+        std::filesystem::remove_all(BENCHMARK_DIRECTORY);
+
+        std::cout << TextUtil::getCommaString(static_cast<uint32_t>(columns.size())) << " columns, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(chunkManager.chunkCount())) << " chunks, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(blockCount)) << " blocks, " <<
+                fileSize / 1024 << " KiB on disk\n";
+        std::cout << "save: " << saveTime * 1000 << " ms, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(columns.size() / saveTime)) << " columns/sec\n";
+        std::cout << "load: " << loadTime * 1000 << " ms, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(columns.size() / loadTime)) << " columns/sec, " <<
+                TextUtil::getCommaString(static_cast<uint32_t>(blockCount / loadTime)) << " blocks/sec\n";
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
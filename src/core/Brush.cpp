@@ -0,0 +1,73 @@
+#include "Brush.h"
+
+#include <algorithm>
+#include <cmath>
+
+Brush Brush::box(const glm::ivec3 &minPos, const glm::ivec3 &maxPos) {
+    const glm::vec3 size = glm::vec3(maxPos - minPos) + 1.0f;
+    return {BrushShape::Box, glm::vec3(minPos + maxPos) * 0.5f, size * 0.5f};
+}
+
+Brush Brush::sphere(const glm::vec3 &center, const float radius) {
+    return {BrushShape::Sphere, center, glm::vec3(radius)};
+}
+
+Brush Brush::cylinder(const glm::vec3 &baseCenter, const float radius, const float height) {
+    return {BrushShape::Cylinder, baseCenter + glm::vec3(0.0f, height * 0.5f, 0.0f), {radius, height * 0.5f, radius}};
+}
+
+bool Brush::contains(const glm::ivec3 &blockPos) const {
+    return getCoverage(blockPos, 1) == BrushCoverage::Inside;
+}
+
+BrushCoverage Brush::getCoverage(const glm::ivec3 &cubeMin, const int cubeSize) const {
+    // the cube's outermost blocks, relative to the brush's center
+    const glm::vec3 low = glm::vec3(cubeMin) - center;
+    const glm::vec3 high = low + static_cast<float>(cubeSize - 1);
+
+    // per axis, how far the nearest and the farthest of the cube's blocks are from the brush's center
+    glm::vec3 nearest;
+    glm::vec3 farthest;
+    for (int axis = 0; axis < 3; axis++) {
+        nearest[axis] = std::max(0.0f, std::max(low[axis], -high[axis]));
+        farthest[axis] = std::max(std::abs(low[axis]), std::abs(high[axis]));
+    }
+
+    bool outside = false;
+    bool inside = true;
+    switch (shape) {
+        case BrushShape::Box:
+            for (int axis = 0; axis < 3; axis++) {
+                outside |= nearest[axis] > halfExtents[axis];
+                inside &= farthest[axis] <= halfExtents[axis];
+            }
+            break;
+        case BrushShape::Sphere: {
+            const float radiusSquared = halfExtents.x * halfExtents.x;
+            outside = glm::dot(nearest, nearest) > radiusSquared;
+            inside = glm::dot(farthest, farthest) <= radiusSquared;
+            break;
+        }
+        case BrushShape::Cylinder: {
+            const float radiusSquared = halfExtents.x * halfExtents.x;
+            outside = nearest.y > halfExtents.y || nearest.x * nearest.x + nearest.z * nearest.z > radiusSquared;
+            inside = farthest.y <= halfExtents.y &&
+                     farthest.x * farthest.x + farthest.z * farthest.z <= radiusSquared;
+            break;
+        }
+    }
+
+    if (outside) {
+        return BrushCoverage::Outside;
+    }
+    return inside ? BrushCoverage::Inside : BrushCoverage::Partial;
+}
+
+// the lowest and highest blocks that can be inside
+glm::ivec3 Brush::getMinBlock() const {
+    return glm::ivec3(glm::ceil(center - halfExtents));
+}
+
+glm::ivec3 Brush::getMaxBlock() const {
+    return glm::ivec3(glm::floor(center + halfExtents));
+}
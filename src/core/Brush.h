@@ -0,0 +1,46 @@
+#ifndef BRUSH_H
+#define BRUSH_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+enum class BrushShape : uint8_t {
+    Box,
+    Sphere,
+    Cylinder
+};
+
+enum class BrushCoverage : uint8_t {
+    Outside,
+    Partial,
+    Inside
+};
+
+// a shape of blocks for ChunkManager::fillBrush and clearBrush, block p is inside if the point p is, as p is the
+// center of the cube it is drawn as. every shape is described by its center and how far it reaches from it along
+// each axis
+struct Brush {
+    BrushShape shape;
+    glm::vec3 center;
+    glm::vec3 halfExtents;
+
+    // the blocks from minPos to maxPos, both inclusive
+    static Brush box(const glm::ivec3 &minPos, const glm::ivec3 &maxPos);
+
+    static Brush sphere(const glm::vec3 &center, float radius);
+
+    // upright, with the center of its bottom at baseCenter
+    static Brush cylinder(const glm::vec3 &baseCenter, float radius, float height);
+
+    [[nodiscard]] bool contains(const glm::ivec3 &blockPos) const;
+
+    // whether the blocks of the cube from cubeMin with the given edge length are all inside, all outside or neither
+    // the shapes are convex, so only the cube's nearest and farthest blocks have to be checked
+    [[nodiscard]] BrushCoverage getCoverage(const glm::ivec3 &cubeMin, int cubeSize) const;
+
+    [[nodiscard]] glm::ivec3 getMinBlock() const;
+
+    [[nodiscard]] glm::ivec3 getMaxBlock() const;
+};
+
+#endif //BRUSH_H
@@ -1,51 +1,214 @@
 #include "Chunk.h"
 
-std::vector<float> SUB_INCREMENTS = {2.0f, 1.0, 0.5};
-float CHUNK_SHIFT = 3.5;
-glm::vec3 CHUNK_SIZE = glm::vec3(8.0f);
-int MAX_DEPTH = 3;
+#include <algorithm>
+#include <array>
+#include <cmath>
 
-OctreeNode::~OctreeNode() = default;
+#ifdef VOXEL_DENSE_CHUNKS
+ChunkStorage DEFAULT_CHUNK_STORAGE = ChunkStorage::Dense;
+#else
+ChunkStorage DEFAULT_CHUNK_STORAGE = ChunkStorage::Octree;
+#endif
 
-InternalNode::InternalNode(const glm::vec3 &position) {
-    for (auto &i: children) {
-        i = nullptr;
+bool DenseBlocks::hasBlock(const int index) const {
+    return getPaletteIndex(index) != 0;
+}
+
+MaterialID DenseBlocks::getMaterial(const int index) const {
+    return palette[getPaletteIndex(index)];
+}
+
+void DenseBlocks::setMaterial(const int index, const MaterialID material) {
+    blockCount += (material != AIR_MATERIAL) - hasBlock(index);
+    setPaletteIndex(index, findOrAddToPalette(material));
+}
+
+void DenseBlocks::fill(const MaterialID material) {
+    palette = {AIR_MATERIAL};
+    bitsPerBlock = 1;
+    paletteIndices.assign(CHUNK_BLOCK_COUNT / 64, 0);
+    blockCount = 0;
+
+    if (material != AIR_MATERIAL) {
+        palette.push_back(material);
+        std::ranges::fill(paletteIndices, ~0ull);
+        blockCount = CHUNK_BLOCK_COUNT;
     }
-    block = Block(position);
 }
 
-InternalNode::~InternalNode() {
-    for (const auto &i: children) {
-        delete i;
+// bit widths are powers of two, so an index never straddles two words
+uint32_t DenseBlocks::getPaletteIndex(const int index) const {
+    const int bitIndex = index * bitsPerBlock;
+    const uint64_t mask = (1ull << bitsPerBlock) - 1;
+    return static_cast<uint32_t>(paletteIndices[bitIndex >> 6] >> (bitIndex & 63) & mask);
+}
+
+void DenseBlocks::setPaletteIndex(const int index, const uint32_t paletteIndex) {
+    const int bitIndex = index * bitsPerBlock;
+    const uint64_t mask = (1ull << bitsPerBlock) - 1;
+    uint64_t &word = paletteIndices[bitIndex >> 6];
+    word = (word & ~(mask << (bitIndex & 63))) | static_cast<uint64_t>(paletteIndex) << (bitIndex & 63);
+}
+
+uint32_t DenseBlocks::findOrAddToPalette(const MaterialID material) {
+    for (uint32_t i = 0; i < palette.size(); i++) {
+        if (palette[i] == material) {
+            return i;
+        }
+    }
+
+    palette.push_back(material);
+    if (palette.size() <= 1u << bitsPerBlock) {
+        return palette.size() - 1;
     }
+
+    // the palette no longer fits, repack every block with twice the bits
+    DenseBlocks widened;
+    widened.bitsPerBlock = bitsPerBlock * 2;
+    widened.paletteIndices.assign(CHUNK_BLOCK_COUNT * widened.bitsPerBlock / 64, 0);
+    for (int i = 0; i < CHUNK_BLOCK_COUNT; i++) {
+        widened.setPaletteIndex(i, getPaletteIndex(i));
+    }
+    paletteIndices = std::move(widened.paletteIndices);
+    bitsPerBlock = widened.bitsPerBlock;
+    return palette.size() - 1;
 }
 
+// the octree lives entirely in nodeArena, which frees it in one go
+// shared DAG nodes are released by ChunkManager::deleteChunk, which has the DAG
 Chunk::~Chunk() {
-    delete octree;
+    delete dense;
+}
+
+// interleaves the local position's bits so that each group of 3 bits, from the top, is the octant at that depth
+// sorting blocks by this index visits them in octree order
+uint32_t Chunk::getMortonIndex(const glm::ivec3 &localPos) {
+    uint32_t mortonIndex = 0;
+    for (int bit = 0; bit < CHUNK_EDGE_BITS; bit++) {
+        mortonIndex |= (localPos.x >> bit & 1) << (3 * bit);
+        mortonIndex |= (localPos.y >> bit & 1) << (3 * bit + 1);
+        mortonIndex |= (localPos.z >> bit & 1) << (3 * bit + 2);
+    }
+    return mortonIndex;
 }
 
-glm::vec3 Chunk::alignToChunkPos(const glm::vec3 &position) {
-    return {alignNum(position.x), alignNum(position.y), alignNum(position.z)};
+glm::ivec3 Chunk::getMortonLocalPos(const uint32_t mortonIndex) {
+    glm::ivec3 localPos(0);
+    for (int bit = 0; bit < CHUNK_EDGE_BITS; bit++) {
+        localPos.x |= static_cast<int>(mortonIndex >> (3 * bit) & 1) << bit;
+        localPos.y |= static_cast<int>(mortonIndex >> (3 * bit + 1) & 1) << bit;
+        localPos.z |= static_cast<int>(mortonIndex >> (3 * bit + 2) & 1) << bit;
+    }
+    return localPos;
 }
 
-double Chunk::alignNum(const double number) {
-    return round((number - CHUNK_SHIFT) / 8) * 8 + CHUNK_SHIFT;
+// the upper octants are searched first, which ends at one of the highest blocks, the surface of a terrain column
+MaterialID Chunk::getLodMaterial(const OctreeNode *node, const int depth) {
+    static constexpr std::array<int, 8> upperOctantsFirst = {2, 3, 6, 7, 0, 1, 4, 5};
+    if (depth == MAX_DEPTH) {
+        return node->material;
+    }
+
+    const auto *internalNode = static_cast<const InternalNode *>(node);
+    for (const int octant: upperOctantsFirst) {
+        if (internalNode->children[octant] != nullptr) {
+            return getLodMaterial(internalNode->children[octant], depth + 1);
+        }
+    }
+    return AIR_MATERIAL;
 }
 
-int Chunk::getOctantIndex(const glm::vec3 &blockPos, const glm::vec3 &chunkPos) {
-    int childIndex = 0;
-    if (blockPos.x >= chunkPos.x) childIndex |= 1;
-    if (blockPos.y >= chunkPos.y) childIndex |= 2;
-    if (blockPos.z >= chunkPos.z) childIndex |= 4;
-    return childIndex;
+// a subtree shared through the DAG is often made of one node repeated eight times, which is then only checked once
+bool Chunk::isFull(const OctreeNode *node, const int depth) {
+    if (node == nullptr || depth == MAX_DEPTH) {
+        return node != nullptr;
+    }
+
+    const auto *internalNode = static_cast<const InternalNode *>(node);
+    for (int i = 0; i < 8; i++) {
+        const OctreeNode *child = internalNode->children[i];
+        if (i > 0 && child == internalNode->children[i - 1]) {
+            continue;
+        }
+        if (!isFull(child, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
 }
 
-void Chunk::addOctantOffset(glm::vec3 &middlePosition, int octantIndex, int depth) {
-    const float xSign = octantIndex & 1 ? 1 : -1;
-    const float ySign = octantIndex & 2 ? 1 : -1;
-    const float zSign = octantIndex & 4 ? 1 : -1;
+bool Chunk::isLayerFull(const OctreeNode *node, const int depth, const int axis, const int layer) {
+    if (node == nullptr || depth == MAX_DEPTH) {
+        return node != nullptr;
+    }
+
+    const auto *internalNode = static_cast<const InternalNode *>(node);
+    const int layerBit = layer >> (CHUNK_EDGE_BITS - 1 - depth) & 1;
+    for (int i = 0; i < 8; i++) {
+        if ((i >> axis & 1) == layerBit && !isLayerFull(internalNode->children[i], depth + 1, axis, layer)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Chunk::isFull() const {
+    if (storage == ChunkStorage::Dense) {
+        return dense->blockCount == CHUNK_BLOCK_COUNT;
+    }
+    return isFull(octree, 0);
+}
+
+bool Chunk::isLayerFull(const int axis, const int layer) const {
+    if (storage == ChunkStorage::Octree) {
+        return isLayerFull(octree, 0, axis, layer);
+    }
+
+    glm::ivec3 localPos(0);
+    localPos[axis] = layer;
+    for (int u = 0; u < CHUNK_EDGE; u++) {
+        for (int v = 0; v < CHUNK_EDGE; v++) {
+            localPos[(axis + 1) % 3] = u;
+            localPos[(axis + 2) % 3] = v;
+            if (!dense->hasBlock(getDenseIndex(localPos))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// block p is drawn as the cube from p - 0.5 to p + 0.5, so a position belongs to the nearest block
+glm::ivec3 Chunk::getBlockPos(const glm::vec3 &position) {
+    return glm::ivec3(glm::floor(position + 0.5f));
+}
+
+// chunk coordinates are block coordinates divided by the chunk size, rounded towards negative infinity
+glm::ivec3 Chunk::getChunkCoords(const glm::vec3 &position) {
+    return getBlockPos(position) >> CHUNK_EDGE_BITS;
+}
+
+glm::ivec3 Chunk::getChunkCorner(const glm::ivec3 &chunkCoords) {
+    return chunkCoords * CHUNK_EDGE;
+}
+
+glm::ivec3 Chunk::getLocalPos(const glm::vec3 &blockPos) {
+    return getBlockPos(blockPos) & CHUNK_EDGE_MASK;
+}
+
+// blocks are laid out x-major, then y, then z, relative to the chunk's lowest corner
+int Chunk::getDenseIndex(const glm::vec3 &blockPos) {
+    return getDenseIndex(getLocalPos(blockPos));
+}
+
+int Chunk::getDenseIndex(const glm::ivec3 &localPos) {
+    return localPos.x | (localPos.y << CHUNK_EDGE_BITS) | (localPos.z << (CHUNK_EDGE_BITS * 2));
+}
 
-    middlePosition.x += xSign * SUB_INCREMENTS[depth];
-    middlePosition.y += SUB_INCREMENTS[depth] * ySign;
-    middlePosition.z += SUB_INCREMENTS[depth] * zSign;
+glm::ivec3 Chunk::getDenseLocalPos(const int denseIndex) {
+    return {
+        denseIndex & CHUNK_EDGE_MASK,
+        denseIndex >> CHUNK_EDGE_BITS & CHUNK_EDGE_MASK,
+        denseIndex >> (CHUNK_EDGE_BITS * 2)
+    };
 }
@@ -3,43 +3,221 @@
 #include <vector>
 
 #include "Block.h"
+#include "ChunkGeometry.h"
+#include "MaterialRegistry.h"
+#include "NodeArena.h"
 #include "../rendering/scene/Vertex.h"
 
-extern std::vector<float> SUB_INCREMENTS;
-extern float CHUNK_SHIFT;
-extern glm::vec3 CHUNK_SIZE;
-extern int MAX_DEPTH;
+// octree chunks are sparse and compress well, dense chunks trade memory for a single indexed load per lookup
+enum class ChunkStorage : uint8_t {
+    Octree,
+    Dense
+};
 
-struct OctreeNode {
-    Block block{};
+extern ChunkStorage DEFAULT_CHUNK_STORAGE;
 
-    virtual ~OctreeNode();
+// nodes don't store their position, it is implied by the path taken from the chunk's root
+// this lets identical subtrees be shared between chunks, see OctreeDag
+// a node's type is implied by its depth as well: nodes above MAX_DEPTH are always InternalNodes
+struct OctreeNode {
+    uint32_t refCount = 0;
+    MaterialID material = AIR_MATERIAL;
 };
 
 struct InternalNode final : OctreeNode {
     OctreeNode *children[8] = {nullptr};
+};
+
+// every block is a bit-packed index into the chunk's palette of materials, index 0 is always air
+// the index width starts at 1 bit and doubles whenever the palette outgrows it
+struct DenseBlocks {
+    std::vector<MaterialID> palette = {AIR_MATERIAL};
+    std::vector<uint64_t> paletteIndices = std::vector<uint64_t>(CHUNK_BLOCK_COUNT / 64);
+    int bitsPerBlock = 1;
+    uint32_t blockCount = 0;
+
+    [[nodiscard]] bool hasBlock(int index) const;
+
+    [[nodiscard]] MaterialID getMaterial(int index) const;
+
+    void setMaterial(int index, MaterialID material);
 
-    explicit InternalNode(const glm::vec3 &position);
+    // sets every block at once, which leaves nothing but the material in the palette
+    void fill(MaterialID material);
 
-    ~InternalNode() override;
+private:
+    [[nodiscard]] uint32_t getPaletteIndex(int index) const;
+
+    void setPaletteIndex(int index, uint32_t paletteIndex);
+
+    uint32_t findOrAddToPalette(MaterialID material);
 };
 
 struct Chunk {
-    OctreeNode *octree;
+    ChunkStorage storage = ChunkStorage::Octree;
+    OctreeNode *octree = nullptr;
+    DenseBlocks *dense = nullptr;
+    NodeArena nodeArena;
+    glm::ivec3 coords{};
     std::vector<ChunkVertex> vertices;
     std::vector<uint32_t> indices;
-    bool geometryModified;
-    uint32_t ID;
+    SliceQuadCounts sliceQuadCounts{};
+    // the mesh only differs from what the vertex pool holds from these positions on
+    uint32_t firstModifiedVertex = 0;
+    uint32_t firstModifiedIndex = 0;
+    // set while the chunk is waiting in ChunkManager's dirty queue, with the slices it needs meshed again
+    bool geometryModified = false;
+    SliceMask dirtySlices{};
+    // the level of detail the chunk is meshed at, picked by ChunkManager from its distance to the camera
+    int lodLevel = 0;
+    uint32_t ID = 0;
 
     ~Chunk();
 
-    static glm::vec3 alignToChunkPos(const glm::vec3 &position);
+    static glm::ivec3 getBlockPos(const glm::vec3 &position);
+
+    static glm::ivec3 getChunkCoords(const glm::vec3 &position);
+
+    static glm::ivec3 getChunkCorner(const glm::ivec3 &chunkCoords);
+
+    static glm::ivec3 getLocalPos(const glm::vec3 &blockPos);
+
+    static int getDenseIndex(const glm::vec3 &blockPos);
+
+    static int getDenseIndex(const glm::ivec3 &localPos);
+
+    static glm::ivec3 getDenseLocalPos(int denseIndex);
+
+    static uint32_t getMortonIndex(const glm::ivec3 &localPos);
+
+    static glm::ivec3 getMortonLocalPos(uint32_t mortonIndex);
+
+    // the material of a voxel that stands for all the blocks below node at a lower level of detail
+    static MaterialID getLodMaterial(const OctreeNode *node, int depth);
+
+    // whether every block below node exists, node may be null
+    static bool isFull(const OctreeNode *node, int depth);
+
+    // like isFull, but only for the blocks below node with localPos[axis] == layer
+    static bool isLayerFull(const OctreeNode *node, int depth, int axis, int layer);
+
+    // whether every block of the chunk exists, or every block of one of its layers
+    [[nodiscard]] bool isFull() const;
+
+    [[nodiscard]] bool isLayerFull(int axis, int layer) const;
+
+    // at each depth the octant is picked by the next highest bit of the block's local position
+    static int getOctantIndex(const glm::ivec3 &localPos, const int depth) {
+        const int bit = CHUNK_EDGE_BITS - 1 - depth;
+        return (localPos.x >> bit & 1) | (localPos.y >> bit & 1) << 1 | (localPos.z >> bit & 1) << 2;
+    }
+
+    static int getOctantIndex(const uint32_t mortonIndex, const int depth) {
+        return static_cast<int>(mortonIndex >> (3 * (MAX_DEPTH - 1 - depth)) & 7);
+    }
+
+    static glm::ivec3 getOctantOffset(const int octantIndex, const int depth) {
+        const int octantSize = 1 << (CHUNK_EDGE_BITS - 1 - depth);
+        return {
+            octantIndex & 1 ? octantSize : 0,
+            octantIndex & 2 ? octantSize : 0,
+            octantIndex & 4 ? octantSize : 0
+        };
+    }
+
+    // calls visitor(leaf, localPos) for every leaf below node, the recursion is resolved at compile time
+    template<int Depth = 0, typename Visitor>
+    static void visitLeaves(const OctreeNode *node, const glm::ivec3 &localPos, Visitor &&visitor) {
+        if constexpr (Depth == MAX_DEPTH) {
+            visitor(node, localPos);
+        }
+        else {
+            const auto *internalNode = static_cast<const InternalNode *>(node);
+            for (int i = 0; i < 8; i++) {
+                if (internalNode->children[i] != nullptr) {
+                    visitLeaves<Depth + 1>(internalNode->children[i], localPos + getOctantOffset(i, Depth), visitor);
+                }
+            }
+        }
+    }
+
+    // calls visitor(node, localPos) for every node at targetDepth below node, each standing for a cube of
+    // 1 << (MAX_DEPTH - targetDepth) blocks. a node only exists there if one of those blocks does
+    template<int Depth = 0, typename Visitor>
+    static void visitDepthNodes(const OctreeNode *node, const glm::ivec3 &localPos, const int targetDepth,
+                                Visitor &&visitor) {
+        if constexpr (Depth == MAX_DEPTH) {
+            visitor(node, localPos);
+        }
+        else {
+            if (Depth == targetDepth) {
+                visitor(node, localPos);
+                return;
+            }
+
+            const auto *internalNode = static_cast<const InternalNode *>(node);
+            for (int i = 0; i < 8; i++) {
+                if (internalNode->children[i] != nullptr) {
+                    visitDepthNodes<Depth + 1>(internalNode->children[i], localPos + getOctantOffset(i, Depth),
+                                               targetDepth, visitor);
+                }
+            }
+        }
+    }
+
+    // like visitLeaves, but only descends into octants that contain blocks with localPos[axis] == layer
+    template<int Depth = 0, typename Visitor>
+    static void visitLayerLeaves(const OctreeNode *node, const glm::ivec3 &localPos, const int axis, const int layer,
+                                 Visitor &&visitor) {
+        if constexpr (Depth == MAX_DEPTH) {
+            visitor(node, localPos);
+        }
+        else {
+            const auto *internalNode = static_cast<const InternalNode *>(node);
+            const int layerBit = layer >> (CHUNK_EDGE_BITS - 1 - Depth) & 1;
+            for (int i = 0; i < 8; i++) {
+                if ((i >> axis & 1) == layerBit && internalNode->children[i] != nullptr) {
+                    visitLayerLeaves<Depth + 1>(internalNode->children[i], localPos + getOctantOffset(i, Depth),
+                                                axis, layer, visitor);
+                }
+            }
+        }
+    }
 
-    static double alignNum(double number);
+    // like visitLeaves, but only descends into octants that overlap the box from boxMin to boxMax, both inclusive
+    // octants that lie entirely inside the box are handed to visitLeaves without checking them any further
+    template<int Depth = 0, typename Visitor>
+    static void visitBoxLeaves(const OctreeNode *node, const glm::ivec3 &localPos, const glm::ivec3 &boxMin,
+                               const glm::ivec3 &boxMax, Visitor &&visitor) {
+        if constexpr (Depth == MAX_DEPTH) {
+            visitor(node, localPos);
+        }
+        else {
+            constexpr int octantSize = 1 << (CHUNK_EDGE_BITS - 1 - Depth);
+            const auto *internalNode = static_cast<const InternalNode *>(node);
+            for (int i = 0; i < 8; i++) {
+                if (internalNode->children[i] == nullptr) {
+                    continue;
+                }
 
-    static int getOctantIndex(const glm::vec3 &blockPos, const glm::vec3 &chunkPos);
+                const glm::ivec3 octantMin = localPos + getOctantOffset(i, Depth);
+                const glm::ivec3 octantMax = octantMin + (octantSize - 1);
+                bool overlaps = true;
+                bool inside = true;
+                for (int axis = 0; axis < 3; axis++) {
+                    overlaps &= octantMin[axis] <= boxMax[axis] && octantMax[axis] >= boxMin[axis];
+                    inside &= octantMin[axis] >= boxMin[axis] && octantMax[axis] <= boxMax[axis];
+                }
 
-    static void addOctantOffset(glm::vec3 &middlePosition, int octantIndex, int depth);
+                if (inside) {
+                    visitLeaves<Depth + 1>(internalNode->children[i], octantMin, visitor);
+                }
+                else if (overlaps) {
+                    visitBoxLeaves<Depth + 1>(internalNode->children[i], octantMin, boxMin, boxMax, visitor);
+                }
+            }
+        }
+    }
 };
 
 #endif //CHUNK_H
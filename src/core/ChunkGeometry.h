@@ -0,0 +1,44 @@
+#ifndef CHUNKGEOMETRY_H
+#define CHUNKGEOMETRY_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// chunk dimensions are fixed at compile time so octree traversals and block loops can be unrolled,
+// build with -DVOXEL_CHUNK_EDGE=16 or 32 for larger chunks
+#ifndef VOXEL_CHUNK_EDGE
+#define VOXEL_CHUNK_EDGE 8
+#endif
+
+constexpr int CHUNK_EDGE = VOXEL_CHUNK_EDGE;
+
+static_assert(std::has_single_bit(static_cast<unsigned>(CHUNK_EDGE)) && CHUNK_EDGE >= 4 && CHUNK_EDGE <= 32,
+              "chunk edge length must be a power of two between 4 and 32");
+
+constexpr int CHUNK_EDGE_BITS = std::countr_zero(static_cast<unsigned>(CHUNK_EDGE));
+constexpr int CHUNK_EDGE_MASK = CHUNK_EDGE - 1;
+constexpr int CHUNK_BLOCK_COUNT = CHUNK_EDGE * CHUNK_EDGE * CHUNK_EDGE;
+
+// the octree's root sits at depth 0 and its leaves (single blocks) at MAX_DEPTH
+constexpr int MAX_DEPTH = CHUNK_EDGE_BITS;
+
+// a chunk at level of detail L is meshed with one voxel per 2^L blocks along each axis
+constexpr int MAX_LOD_LEVEL = 2;
+
+// a slice is one layer of faces that point the same way, slice face * CHUNK_EDGE + layer
+// meshes are kept in slice order so an edit only has to redo the few slices around it
+constexpr int CHUNK_SLICE_COUNT = 6 * CHUNK_EDGE;
+
+// bit l of entry f selects the slice of face f at layer l
+using SliceMask = std::array<uint32_t, 6>;
+
+// the number of quads each slice of a chunk's mesh has, in the order they appear in its vertices
+using SliceQuadCounts = std::array<uint16_t, CHUNK_SLICE_COUNT>;
+
+constexpr uint32_t ALL_CHUNK_LAYERS = static_cast<uint32_t>((1ull << CHUNK_EDGE) - 1);
+constexpr SliceMask ALL_CHUNK_SLICES = {
+    ALL_CHUNK_LAYERS, ALL_CHUNK_LAYERS, ALL_CHUNK_LAYERS, ALL_CHUNK_LAYERS, ALL_CHUNK_LAYERS, ALL_CHUNK_LAYERS
+};
+
+#endif //CHUNKGEOMETRY_H
@@ -1,223 +1,965 @@
 #include "ChunkManager.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <tuple>
 #include <glm/common.hpp>
 
 #include "../rendering/scene/VertexPool.h"
-#include "../util/VertexUtil.h"
+#include "../util/ThreadPool.h"
 #include "../util/TimeManager.h"
+#include "../util/VertexUtil.h"
 
 uint32_t ChunkManager::currentID = 1;
 
 Chunk* ChunkManager::getChunk(const glm::vec3& worldPos) {
-    auto it = chunks.find(Chunk::alignToChunkPos(worldPos));
+    return getChunk(Chunk::getChunkCoords(worldPos));
+}
+
+Chunk* ChunkManager::getChunk(const glm::ivec3& chunkCoords) {
+    auto it = chunks.find(chunkCoords);
     if (it != chunks.end()) {
         return &it->second;
     }
     return nullptr;
 }
 
-void ChunkManager::createChunk(const glm::vec3& worldPos) {
-    glm::vec3 normalizedChunkPos = (worldPos - CHUNK_SHIFT) / CHUNK_SIZE;
+Chunk& ChunkManager::createChunk(const glm::ivec3& chunkCoords, const ChunkStorage storage) {
+    auto [it, inserted] = chunks.try_emplace(chunkCoords);
 
-    if (std::floor(normalizedChunkPos.x) != normalizedChunkPos.x ||
-        std::floor(normalizedChunkPos.y) != normalizedChunkPos.y ||
-        std::floor(normalizedChunkPos.z) != normalizedChunkPos.z) {
-        throw std::runtime_error("chunk creation error: location invalid!");
+    if (!inserted) {
+        throw std::runtime_error("chunk creation error: chunk already exists!");
     }
 
-    if (chunks.contains(worldPos)) {
-        throw std::runtime_error("chunk creation error: chunk already exists!");
+    Chunk& chunk = it->second;
+    chunk.storage = storage;
+    chunk.coords = chunkCoords;
+    if (storage == ChunkStorage::Dense) {
+        chunk.dense = new DenseBlocks();
+    }
+    else {
+        chunk.octree = chunk.nodeArena.create<InternalNode>();
+    }
+    chunk.geometryModified = false;
+    chunk.lodLevel = 0;
+    if (lodDistance > 0.0f && lodCameraChunk.has_value()) {
+        chunk.lodLevel = selectLodLevel(chunk);
+    }
+    chunk.ID = currentID++;
+    return chunk;
+}
+
+void ChunkManager::deleteChunk(const glm::ivec3& chunkCoords) {
+    const auto it = chunks.find(chunkCoords);
+    if (it == chunks.end()) {
+        throw std::runtime_error("chunk deletion error: chunk doesn't exist!");
     }
 
-    chunks[worldPos] = Chunk();
-    chunks[worldPos].octree = new InternalNode(worldPos);
-    chunks[worldPos].geometryModified = false;
-    chunks[worldPos].ID = currentID++;
+    Chunk& chunk = it->second;
+    markNeighbourBordersDirty(chunk);
+    if (chunk.storage == ChunkStorage::Octree) {
+        octreeDag.releaseTree(chunk.octree, 0);
+    }
+    VertexPool::removeFromVertexPool(chunk.ID);
+    chunks.erase(it);
 }
 
-void ChunkManager::meshChunk(Chunk& chunk) {
-    chunk.vertices = { };
-    chunk.indices = { };
-    std::array<bool, 6> facesToDraw{};
+static bool isSliceSelected(const SliceMask& slices, const int slice) {
+    return (slices[slice / CHUNK_EDGE] >> (slice % CHUNK_EDGE) & 1) != 0;
+}
 
-    for (const auto& topNode : dynamic_cast<InternalNode*>(chunk.octree)->children) {
-        if (topNode == nullptr) {
-            continue;
+// only reads other chunks, so different chunks can be meshed at the same time
+// the queued slices are meshed again and spliced into the old mesh, everything before the first of them is kept
+// in place, so the vertex pool only has to take the mesh from there on
+MeshStats ChunkManager::meshChunk(Chunk& chunk) const {
+    if (isBuried(chunk)) {
+        chunk.vertices = { };
+        chunk.indices = { };
+        chunk.sliceQuadCounts = { };
+        chunk.firstModifiedVertex = 0;
+        chunk.firstModifiedIndex = 0;
+        chunk.dirtySlices = { };
+        chunk.geometryModified = false;
+        return { };
+    }
+
+    const ChunkSnapshot snapshot = createSnapshot(chunk);
+    const SliceMask slices = chunk.dirtySlices;
+    chunk.dirtySlices = { };
+    chunk.geometryModified = false;
+
+    // the slices of a lower level of detail are layers of voxels rather than blocks, so those are always meshed whole
+    if (slices == ALL_CHUNK_SLICES || snapshot.lodLevel > 0) {
+        chunk.vertices = { };
+        chunk.indices = { };
+        chunk.firstModifiedVertex = 0;
+        chunk.firstModifiedIndex = 0;
+        return ChunkMesher::meshSlices(snapshot, ALL_CHUNK_SLICES, chunk.vertices, chunk.indices,
+                                       chunk.sliceQuadCounts);
+    }
+
+    std::vector<ChunkVertex> sliceVertices;
+    std::vector<uint32_t> sliceIndices;
+    SliceQuadCounts newQuadCounts = chunk.sliceQuadCounts;
+    const MeshStats stats = ChunkMesher::meshSlices(snapshot, slices, sliceVertices, sliceIndices, newQuadCounts);
+
+    int firstSlice = 0;
+    uint32_t firstVertex = 0;
+    while (firstSlice < CHUNK_SLICE_COUNT && !isSliceSelected(slices, firstSlice)) {
+        firstVertex += chunk.sliceQuadCounts[firstSlice] * 4;
+        firstSlice++;
+    }
+
+    const std::vector<ChunkVertex> oldVertices(chunk.vertices.begin() + firstVertex, chunk.vertices.end());
+    chunk.vertices.resize(firstVertex);
+    auto oldSlice = oldVertices.begin();
+    auto newSlice = sliceVertices.begin();
+    for (int slice = firstSlice; slice < CHUNK_SLICE_COUNT; slice++) {
+        const uint32_t oldVertexCount = chunk.sliceQuadCounts[slice] * 4;
+        if (isSliceSelected(slices, slice)) {
+            const uint32_t newVertexCount = newQuadCounts[slice] * 4;
+            chunk.vertices.insert(chunk.vertices.end(), newSlice, newSlice + newVertexCount);
+            newSlice += newVertexCount;
         }
-        for (const auto& middleNode : dynamic_cast<InternalNode*>(topNode)->children) {
-            if (middleNode == nullptr) {
-                continue;
-            }
-            for (const auto blockNode : dynamic_cast<InternalNode*>(middleNode)->children) {
-                if (blockNode != nullptr) {
-                    generateBlockMesh(chunk, blockNode->block, facesToDraw);
-                }
-            }
+        else {
+            chunk.vertices.insert(chunk.vertices.end(), oldSlice, oldSlice + oldVertexCount);
         }
+        oldSlice += oldVertexCount;
     }
+    chunk.sliceQuadCounts = newQuadCounts;
 
-    chunk.geometryModified = false;
+    // every quad has the same indices relative to its first vertex, so only a longer mesh needs new ones
+    const auto quadCount = static_cast<uint32_t>(chunk.vertices.size() / 4);
+    chunk.indices.resize(std::min<size_t>(chunk.indices.size(), quadCount * 6));
+    chunk.firstModifiedVertex = firstVertex;
+    chunk.firstModifiedIndex = static_cast<uint32_t>(chunk.indices.size());
+    for (uint32_t quad = chunk.indices.size() / 6; quad < quadCount; quad++) {
+        insertQuadIndices(chunk.indices, quad * 4);
+    }
+
+    return stats;
 }
 
-void ChunkManager::generateBlockMesh(Chunk& chunk, Block& block, std::array<bool, 6>& facesToDraw) {
-    std::fill(facesToDraw.begin(), facesToDraw.end(), true);
+// offsets to the six chunks that share a face with a chunk
+static constexpr std::array<glm::ivec3, 6> neighbourOffsets = {
+    {
+        {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}
+    }
+};
 
-    int faceCount = 0;
-    if (hasBlock(block.position + glm::vec3(0, 1, 0))) {
-        facesToDraw[0] = false;
-        faceCount++;
+// a full chunk whose six neighbours all have full layers against it has no visible faces at any level of detail,
+// which is most of the chunks below solid terrain, so those skip the snapshot and the mesher
+bool ChunkManager::isBuried(const Chunk& chunk) const {
+    if (!chunk.isFull()) {
+        return false;
     }
-    if (hasBlock(block.position + glm::vec3(0, -1, 0))) {
-        facesToDraw[1] = false;
-        faceCount++;
+
+    for (const glm::ivec3& offset : neighbourOffsets) {
+        auto it = chunks.find(chunk.coords + offset);
+        const int axis = offset.x != 0 ? 0 : offset.y != 0 ? 1 : 2;
+        const int layer = offset[axis] > 0 ? 0 : CHUNK_EDGE - 1;
+        if (it == chunks.end() || !it->second.isLayerFull(axis, layer)) {
+            return false;
+        }
     }
-    if (hasBlock(block.position + glm::vec3(0, 0, 1))) {
-        facesToDraw[2] = false;
-        faceCount++;
+    return true;
+}
+
+// at a lower level of detail a voxel exists wherever one of its blocks does, so distant terrain keeps its shape
+// instead of breaking up. in an octree chunk those voxels are the nodes at the matching depth
+ChunkSnapshot ChunkManager::createSnapshot(const Chunk& chunk) const {
+    ChunkSnapshot snapshot;
+    snapshot.coords = chunk.coords;
+    snapshot.lodLevel = chunk.lodLevel;
+    const int lodLevel = chunk.lodLevel;
+    const int lodEdge = snapshot.getLodEdge();
+
+    if (chunk.storage == ChunkStorage::Dense && lodLevel == 0) {
+        for (int i = 0; i < CHUNK_BLOCK_COUNT; i++) {
+            snapshot.setMaterial(Chunk::getDenseLocalPos(i), chunk.dense->getMaterial(i));
+        }
     }
-    if (hasBlock(block.position + glm::vec3(0, 0, -1))) {
-        facesToDraw[3] = false;
-        faceCount++;
+    else if (chunk.storage == ChunkStorage::Dense) {
+        // going from the top down, each voxel takes the material of one of its highest blocks
+        for (int y = CHUNK_EDGE - 1; y >= 0; y--) {
+            for (int z = 0; z < CHUNK_EDGE; z++) {
+                for (int x = 0; x < CHUNK_EDGE; x++) {
+                    const glm::ivec3 localPos(x, y, z);
+                    const MaterialID material = chunk.dense->getMaterial(Chunk::getDenseIndex(localPos));
+                    if (material != AIR_MATERIAL && !snapshot.hasBlock(localPos >> lodLevel)) {
+                        snapshot.setMaterial(localPos >> lodLevel, material);
+                    }
+                }
+            }
+        }
     }
-    if (hasBlock(block.position + glm::vec3(-1, 0, 0))) {
-        facesToDraw[4] = false;
-        faceCount++;
+    else if (lodLevel == 0) {
+        Chunk::visitLeaves(chunk.octree, glm::ivec3(0), [&](const OctreeNode* blockNode, const glm::ivec3& localPos) {
+            snapshot.setMaterial(localPos, blockNode->material);
+        });
     }
-    if (hasBlock(block.position + glm::vec3(1, 0, 0))) {
-        facesToDraw[5] = false;
-        faceCount++;
+    else {
+        const int lodDepth = MAX_DEPTH - lodLevel;
+        Chunk::visitDepthNodes(chunk.octree, glm::ivec3(0), lodDepth,
+                               [&](const OctreeNode* lodNode, const glm::ivec3& localPos) {
+                                   snapshot.setMaterial(localPos >> lodLevel, Chunk::getLodMaterial(lodNode, lodDepth));
+                               });
     }
 
-    if (faceCount > 0) {
-        insertBlockIndices(chunk.indices, facesToDraw, chunk.vertices.size());
-        insertBlockVertices(chunk.vertices, facesToDraw, block.position, block.color);
+    // only the layer of each neighbour that touches this chunk is copied, entry u + v * CHUNK_EDGE holds the block
+    // at (u, v) on the two other axes
+    std::array<MaterialID, CHUNK_COLUMN_COUNT> layerMaterials;
+    for (const glm::ivec3& offset : neighbourOffsets) {
+        auto it = chunks.find(chunk.coords + offset);
+        if (it == chunks.end()) {
+            continue;
+        }
+
+        const Chunk& neighbour = it->second;
+        const int axis = offset.x != 0 ? 0 : offset.y != 0 ? 1 : 2;
+        const int layer = offset[axis] > 0 ? 0 : CHUNK_EDGE - 1;
+        layerMaterials.fill(AIR_MATERIAL);
+
+        if (neighbour.storage == ChunkStorage::Dense) {
+            glm::ivec3 localPos(0);
+            localPos[axis] = layer;
+            for (int u = 0; u < CHUNK_EDGE; u++) {
+                for (int v = 0; v < CHUNK_EDGE; v++) {
+                    localPos[(axis + 1) % 3] = u;
+                    localPos[(axis + 2) % 3] = v;
+                    layerMaterials[u + v * CHUNK_EDGE] = neighbour.dense->getMaterial(Chunk::getDenseIndex(localPos));
+                }
+            }
+        }
+        else {
+            Chunk::visitLayerLeaves(neighbour.octree, glm::ivec3(0), axis, layer,
+                                    [&](const OctreeNode* blockNode, const glm::ivec3& localPos) {
+                                        layerMaterials[localPos[(axis + 1) % 3] +
+                                                       localPos[(axis + 2) % 3] * CHUNK_EDGE] = blockNode->material;
+                                    });
+        }
+
+        // a face may only be hidden where the neighbour's mesh is sure to cover it. a neighbour meshed at this level
+        // of detail or a lower one draws a whole voxel over the face once any of the blocks behind it exists, one
+        // meshed at a higher level only covers the face if all of those blocks do
+        const int voxelSize = 1 << lodLevel;
+        const bool anyBlockCovers = neighbour.lodLevel >= lodLevel;
+        glm::ivec3 paddingPos(0);
+        paddingPos[axis] = offset[axis] > 0 ? lodEdge : -1;
+        for (int v = 0; v < lodEdge; v++) {
+            for (int u = 0; u < lodEdge; u++) {
+                MaterialID material = AIR_MATERIAL;
+                for (int i = 0; i < voxelSize * voxelSize; i++) {
+                    const int layerU = u * voxelSize + i % voxelSize;
+                    const int layerV = v * voxelSize + i / voxelSize;
+                    const MaterialID layerMaterial = layerMaterials[layerU + layerV * CHUNK_EDGE];
+                    if (layerMaterial != AIR_MATERIAL) {
+                        material = layerMaterial;
+                        if (anyBlockCovers) {
+                            break;
+                        }
+                    }
+                    else if (!anyBlockCovers) {
+                        material = AIR_MATERIAL;
+                        break;
+                    }
+                }
+
+                paddingPos[(axis + 1) % 3] = u;
+                paddingPos[(axis + 2) % 3] = v;
+                snapshot.setMaterial(paddingPos, material);
+            }
+        }
     }
+
+    return snapshot;
+}
+
+bool ChunkManager::canEditColumn(const glm::ivec2& column) const {
+    return !isColumnEditable || isColumnEditable(column);
 }
 
 void ChunkManager::addBlock(const Block& block) {
-    const glm::vec3 chunkCenter = Chunk::alignToChunkPos(block.position);
-    Chunk* chunk = getChunk(chunkCenter);
+    const glm::ivec3 chunkCoords = Chunk::getChunkCoords(block.position);
+    if (!canEditColumn({chunkCoords.x, chunkCoords.z})) {
+        return;
+    }
+    Chunk* chunk = getChunk(chunkCoords);
 
     if (chunk == nullptr) {
-        createChunk(chunkCenter);
-        chunk = getChunk(chunkCenter);
+        chunk = &createChunk(chunkCoords);
     }
 
-    OctreeNode* newBlockNode = createPathToBlock(chunk, block);
-    Block::copyBlock(newBlockNode->block, block);
+    const MaterialID material = MaterialRegistry::getMaterialID(block.color);
 
-    chunk->geometryModified = true;
+    if (chunk->storage == ChunkStorage::Dense) {
+        chunk->dense->setMaterial(Chunk::getDenseIndex(block.position), material);
+    }
+    else {
+        OctreeNode* newBlockNode = createPathToBlock(chunk, block);
+        newBlockNode->material = material;
+    }
+
+    markBlockDirty(*chunk, Chunk::getLocalPos(block.position));
+    editedColumns.insert({chunkCoords.x, chunkCoords.z});
 }
 
-OctreeNode* ChunkManager::createPathToBlock(const Chunk* chunk, const Block& block) {
-    auto* currentNode = dynamic_cast<InternalNode*>(chunk->octree);
-    OctreeNode* newBlockNode = nullptr;
-    int depth = 0;
+// inserts blocks grouped by chunk, so each chunk is looked up once and filled in a single pass
+// later blocks overwrite earlier ones at the same position, the same as calling addBlock for each of them
+void ChunkManager::addBlocks(const std::span<const Block> blocks) {
+    std::vector<PendingBlock> pendingBlocks;
+    std::vector<uint32_t> blockBuckets;
+    std::vector<glm::ivec3> bucketChunks;
+    std::unordered_map<glm::ivec3, uint32_t> bucketIDs;
+    pendingBlocks.reserve(blocks.size());
+    blockBuckets.reserve(blocks.size());
 
-    while (depth < MAX_DEPTH) {
-        const int octantIndex = Chunk::getOctantIndex(block.position, currentNode->block.position);
+    // inputs tend to reuse a handful of colors and runs of blocks share a chunk, so colors go through a small
+    // direct-mapped cache in front of the material registry, and the chunk lookup is skipped while it repeats
+    std::array<uint32_t, 64> cachedColors{};
+    std::array<MaterialID, 64> cachedMaterials{};
+    uint32_t lastBucket = 0;
+    for (const Block& block : blocks) {
+        uint32_t colorKey;
+        std::memcpy(&colorKey, block.color, sizeof(colorKey));
+        const uint32_t cacheSlot = colorKey * 0x9e3779b1u >> 26;
+        if (cachedMaterials[cacheSlot] == AIR_MATERIAL || cachedColors[cacheSlot] != colorKey) {
+            cachedMaterials[cacheSlot] = MaterialRegistry::getMaterialID(block.color);
+            cachedColors[cacheSlot] = colorKey;
+        }
 
-        if (depth < MAX_DEPTH - 1 && currentNode->children[octantIndex] != nullptr) {
-            currentNode = dynamic_cast<InternalNode*>(currentNode->children[octantIndex]);
-            depth++;
-            continue;
+        const glm::ivec3 blockPos = Chunk::getBlockPos(block.position);
+        const glm::ivec3 chunkCoords = blockPos >> CHUNK_EDGE_BITS;
+        if (bucketChunks.empty() || bucketChunks[lastBucket] != chunkCoords) {
+            auto [it, inserted] = bucketIDs.try_emplace(chunkCoords, static_cast<uint32_t>(bucketChunks.size()));
+            if (inserted) {
+                bucketChunks.push_back(chunkCoords);
+            }
+            lastBucket = it->second;
         }
 
-        if (depth == MAX_DEPTH && currentNode->children[octantIndex] != nullptr) {
-            newBlockNode = currentNode->children[octantIndex];
-            break;
+        pendingBlocks.push_back({
+            chunkCoords,
+            Chunk::getMortonIndex(blockPos & CHUNK_EDGE_MASK),
+            cachedMaterials[cacheSlot]
+        });
+        blockBuckets.push_back(lastBucket);
+    }
+
+    // counting sort by chunk keeps the input order within each chunk
+    std::vector<uint32_t> bucketStarts(bucketChunks.size() + 1, 0);
+    for (const uint32_t bucket : blockBuckets) {
+        bucketStarts[bucket + 1]++;
+    }
+    for (size_t i = 1; i < bucketStarts.size(); i++) {
+        bucketStarts[i] += bucketStarts[i - 1];
+    }
+
+    std::vector<PendingBlock> sortedBlocks(pendingBlocks.size());
+    std::vector<uint32_t> bucketCursors(bucketStarts.begin(), bucketStarts.end() - 1);
+    for (size_t i = 0; i < pendingBlocks.size(); i++) {
+        sortedBlocks[bucketCursors[blockBuckets[i]]++] = pendingBlocks[i];
+    }
+
+    for (size_t bucket = 0; bucket < bucketChunks.size(); bucket++) {
+        const auto chunkBlocks = std::span(sortedBlocks).subspan(bucketStarts[bucket],
+                                                                 bucketStarts[bucket + 1] - bucketStarts[bucket]);
+
+        Chunk* chunk = getChunk(bucketChunks[bucket]);
+        if (chunk == nullptr) {
+            chunk = &createChunk(bucketChunks[bucket]);
         }
+        insertIntoChunk(*chunk, chunkBlocks);
+        markChunkDirty(*chunk);
+        markNeighbourBordersDirty(*chunk);
+    }
+}
 
-        glm::vec3 childPos = currentNode->block.position;
-        Chunk::addOctantOffset(childPos, octantIndex, depth);
+void ChunkManager::restoreChunk(Chunk& chunk, const std::span<const PendingBlock> blocks) {
+    insertIntoChunk(chunk, blocks);
+}
+
+// the path of the previous block is kept, so only the part below the first octant where the two morton indices
+// differ is walked again. blocks that are close together (as terrain columns are) share most of their path
+void ChunkManager::insertIntoChunk(Chunk& chunk, const std::span<const PendingBlock> blocks) {
+    if (chunk.storage == ChunkStorage::Dense) {
+        for (const PendingBlock& block : blocks) {
+            chunk.dense->setMaterial(Chunk::getDenseIndex(Chunk::getMortonLocalPos(block.mortonIndex)), block.material);
+        }
+        return;
+    }
+
+    chunk.octree = makeNodePrivate(&chunk, chunk.octree, 0);
+    InternalNode* path[MAX_DEPTH];
+    path[0] = static_cast<InternalNode*>(chunk.octree);
+
+    uint32_t previousIndex = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        const uint32_t mortonIndex = blocks[i].mortonIndex;
+
+        int depth = 0;
+        if (i > 0) {
+            while (depth < MAX_DEPTH - 1 &&
+                   Chunk::getOctantIndex(mortonIndex, depth) == Chunk::getOctantIndex(previousIndex, depth)) {
+                depth++;
+            }
+        }
+
+        for (; depth < MAX_DEPTH; depth++) {
+            OctreeNode*& childNode = path[depth]->children[Chunk::getOctantIndex(mortonIndex, depth)];
 
-        if (depth < MAX_DEPTH - 1) {
-            currentNode->children[octantIndex] = new InternalNode(childPos);
-            currentNode = dynamic_cast<InternalNode*>(currentNode->children[octantIndex]);
+            if (childNode == nullptr) {
+                if (depth < MAX_DEPTH - 1) {
+                    childNode = chunk.nodeArena.create<InternalNode>();
+                }
+                else {
+                    childNode = chunk.nodeArena.create<OctreeNode>();
+                }
+            }
+            else {
+                childNode = makeNodePrivate(&chunk, childNode, depth + 1);
+            }
+
+            if (depth < MAX_DEPTH - 1) {
+                path[depth + 1] = static_cast<InternalNode*>(childNode);
+            }
+            else {
+                childNode->material = blocks[i].material;
+            }
+        }
+
+        previousIndex = mortonIndex;
+    }
+}
+
+OctreeNode* ChunkManager::createPathToBlock(Chunk* chunk, const Block& block) {
+    const glm::ivec3 localPos = Chunk::getLocalPos(block.position);
+    chunk->octree = makeNodePrivate(chunk, chunk->octree, 0);
+    auto* currentNode = static_cast<InternalNode*>(chunk->octree);
+    int depth = 0;
+
+    while (depth < MAX_DEPTH) {
+        const int octantIndex = Chunk::getOctantIndex(localPos, depth);
+        OctreeNode*& childNode = currentNode->children[octantIndex];
+
+        if (childNode == nullptr) {
+            if (depth < MAX_DEPTH - 1) {
+                childNode = chunk->nodeArena.create<InternalNode>();
+            }
+            else {
+                childNode = chunk->nodeArena.create<OctreeNode>();
+            }
         }
         else {
-            currentNode->children[octantIndex] = new OctreeNode();
-            newBlockNode = currentNode->children[octantIndex];
+            childNode = makeNodePrivate(chunk, childNode, depth + 1);
         }
 
+        if (depth == MAX_DEPTH - 1) {
+            return childNode;
+        }
+
+        currentNode = static_cast<InternalNode*>(childNode);
         depth++;
     }
 
-    if (newBlockNode == nullptr) {
-        throw std::runtime_error("failed to add block!");
+    throw std::runtime_error("failed to add block!");
+}
+
+// copy-on-write for nodes shared through the octree DAG, chunk-owned nodes are returned as they are
+OctreeNode* ChunkManager::makeNodePrivate(Chunk* chunk, OctreeNode* node, const int depth) {
+    if (node->refCount == 0) {
+        return node;
     }
 
-    return newBlockNode;
+    OctreeNode* privateNode = OctreeDag::copyNode(chunk->nodeArena, node, depth);
+    octreeDag.release(node, depth);
+    return privateNode;
 }
 
 Block ChunkManager::getBlock(const glm::vec3& worldPos) {
-    const OctreeNode* blockTree = findOctreeNode(worldPos);
+    const Chunk* chunk = getChunk(worldPos);
+
+    if (chunk != nullptr && chunk->storage == ChunkStorage::Dense) {
+        const int denseIndex = Chunk::getDenseIndex(worldPos);
+        if (!chunk->dense->hasBlock(denseIndex)) {
+            throw std::runtime_error("error getting block!");
+        }
+        return MaterialRegistry::getBlock(chunk->dense->getMaterial(denseIndex),
+                                          glm::vec3(Chunk::getBlockPos(worldPos)));
+    }
+
+    const OctreeNode* blockTree = findOctreeNode(chunk, worldPos);
 
     if (blockTree == nullptr) {
         throw std::runtime_error("error getting block!");
     }
 
-    return blockTree->block;
+    return MaterialRegistry::getBlock(blockTree->material, glm::vec3(Chunk::getBlockPos(worldPos)));
 }
 
 bool ChunkManager::hasBlock(const glm::vec3& worldPos) {
-    OctreeNode* blockTree = findOctreeNode(worldPos);
-    return blockTree != nullptr;
+    const Chunk* chunk = getChunk(worldPos);
+
+    if (chunk != nullptr && chunk->storage == ChunkStorage::Dense) {
+        return chunk->dense->hasBlock(Chunk::getDenseIndex(worldPos));
+    }
+
+    return findOctreeNode(chunk, worldPos) != nullptr;
 }
 
-void ChunkManager::removeBlock(const glm::vec3& worldPos) { //todo remove geometry
-    OctreeNode* blockTree = findOctreeNode(worldPos);
+// the block's material if there is one, otherwise the largest empty cell around the block, which is an octant the
+// octree has no node for. cellCorner starts at the chunk's local origin and cellSize at the chunk edge
+static MaterialID findRayCell(const Chunk& chunk, const glm::ivec3& localPos, glm::ivec3& cellCorner, int& cellSize) {
+    if (chunk.storage == ChunkStorage::Dense) {
+        cellCorner = localPos;
+        cellSize = 1;
+        return chunk.dense->getMaterial(Chunk::getDenseIndex(localPos));
+    }
 
-    if (blockTree == nullptr) {
+    const OctreeNode* node = chunk.octree;
+    for (int depth = 0; depth < MAX_DEPTH; depth++) {
+        const int octantIndex = Chunk::getOctantIndex(localPos, depth);
+        cellCorner += Chunk::getOctantOffset(octantIndex, depth);
+        cellSize >>= 1;
+        node = static_cast<const InternalNode*>(node)->children[octantIndex];
+        if (node == nullptr) {
+            return AIR_MATERIAL;
+        }
+    }
+    return node->material;
+}
+
+// the ray is stepped from cell to cell, leaving each through the face it reaches first. block p is drawn from p - 0.5
+// to p + 0.5, so the walk happens half a block over where block p covers p to p + 1 and cells start at their corner.
+// the block it enters next is found by flooring the exit point, clamped to the cell on the other axes so rounding
+// can't undo the step
+std::optional<RaycastHit> ChunkManager::raycast(const glm::vec3& origin, const glm::vec3& direction,
+                                                const float maxDistance) const {
+    const float directionLength = glm::length(direction);
+    if (directionLength == 0.0f) {
+        return std::nullopt;
+    }
+    const glm::vec3 rayDirection = direction / directionLength;
+
+    const glm::vec3 cellOrigin = origin + 0.5f;
+    glm::ivec3 blockPos = glm::ivec3(glm::floor(cellOrigin));
+    glm::ivec3 normal(0);
+    float distance = 0.0f;
+    glm::ivec3 chunkCoords = blockPos >> CHUNK_EDGE_BITS;
+    auto chunkIt = chunks.find(chunkCoords);
+
+    while (distance <= maxDistance) {
+        if (const glm::ivec3 blockChunkCoords = blockPos >> CHUNK_EDGE_BITS; blockChunkCoords != chunkCoords) {
+            chunkCoords = blockChunkCoords;
+            chunkIt = chunks.find(chunkCoords);
+        }
+
+        glm::ivec3 cellCorner(0);
+        int cellSize = CHUNK_EDGE;
+        if (chunkIt != chunks.end()) {
+            const MaterialID material = findRayCell(chunkIt->second, blockPos & CHUNK_EDGE_MASK, cellCorner, cellSize);
+            if (material != AIR_MATERIAL) {
+                return RaycastHit{blockPos, normal, distance, material};
+            }
+        }
+        cellCorner += Chunk::getChunkCorner(chunkCoords);
+
+        int exitAxis = 0;
+        float exitDistance = std::numeric_limits<float>::infinity();
+        for (int axis = 0; axis < 3; axis++) {
+            if (rayDirection[axis] == 0.0f) {
+                continue;
+            }
+            const int exitFace = rayDirection[axis] > 0.0f ? cellCorner[axis] + cellSize : cellCorner[axis];
+            const float axisDistance = (static_cast<float>(exitFace) - cellOrigin[axis]) / rayDirection[axis];
+            if (axisDistance < exitDistance) {
+                exitAxis = axis;
+                exitDistance = axisDistance;
+            }
+        }
+
+        distance = std::max(distance, exitDistance);
+        for (int axis = 0; axis < 3; axis++) {
+            if (axis == exitAxis) {
+                blockPos[axis] = rayDirection[axis] > 0.0f ? cellCorner[axis] + cellSize : cellCorner[axis] - 1;
+            }
+            else {
+                const int exitBlock = static_cast<int>(std::floor(cellOrigin[axis] + rayDirection[axis] * distance));
+                blockPos[axis] = std::clamp(exitBlock, cellCorner[axis], cellCorner[axis] + cellSize - 1);
+            }
+        }
+        normal = glm::ivec3(0);
+        normal[exitAxis] = rayDirection[exitAxis] > 0.0f ? -1 : 1;
+    }
+
+    return std::nullopt;
+}
+
+// a box with fewer chunks in it than the chunk map has is looked up chunk by chunk, a larger one is found by going
+// through the chunk map instead, so a huge box over a small world doesn't look up millions of missing chunks
+std::vector<glm::ivec3> ChunkManager::findChunksInBox(const glm::ivec3& minChunk, const glm::ivec3& maxChunk) const {
+    std::vector<glm::ivec3> boxChunks;
+    if (maxChunk.x < minChunk.x || maxChunk.y < minChunk.y || maxChunk.z < minChunk.z) {
+        return boxChunks;
+    }
+
+    const uint64_t boxChunkCount = static_cast<uint64_t>(maxChunk.x - minChunk.x + 1) *
+                                   static_cast<uint64_t>(maxChunk.y - minChunk.y + 1) *
+                                   static_cast<uint64_t>(maxChunk.z - minChunk.z + 1);
+    if (boxChunkCount <= chunks.size()) {
+        for (int z = minChunk.z; z <= maxChunk.z; z++) {
+            for (int y = minChunk.y; y <= maxChunk.y; y++) {
+                for (int x = minChunk.x; x <= maxChunk.x; x++) {
+                    if (chunks.contains({x, y, z})) {
+                        boxChunks.emplace_back(x, y, z);
+                    }
+                }
+            }
+        }
+        return boxChunks;
+    }
+
+    for (const auto& [chunkCoords, chunk] : chunks) {
+        if (chunkCoords.x >= minChunk.x && chunkCoords.y >= minChunk.y && chunkCoords.z >= minChunk.z &&
+            chunkCoords.x <= maxChunk.x && chunkCoords.y <= maxChunk.y && chunkCoords.z <= maxChunk.z) {
+            boxChunks.push_back(chunkCoords);
+        }
+    }
+    std::ranges::sort(boxChunks, [](const glm::ivec3& a, const glm::ivec3& b) {
+        return std::tie(a.z, a.y, a.x) < std::tie(b.z, b.y, b.x);
+    });
+    return boxChunks;
+}
+
+void ChunkManager::visitRegion(const glm::ivec3& minPos, const glm::ivec3& maxPos,
+                               const RegionVisitor& visitor) const {
+    if (maxPos.x < minPos.x || maxPos.y < minPos.y || maxPos.z < minPos.z) {
+        return;
+    }
+
+    std::vector<const Chunk*> boxChunks;
+    for (const glm::ivec3& chunkCoords : findChunksInBox(minPos >> CHUNK_EDGE_BITS, maxPos >> CHUNK_EDGE_BITS)) {
+        boxChunks.push_back(&chunks.at(chunkCoords));
+    }
+
+    // the chunk's blocks in the box are first gathered into one bit per block along x, then the runs are read off
+    // the rows with a count of trailing zeros, so rows without blocks cost nothing
+    std::array<uint32_t, CHUNK_EDGE * CHUNK_EDGE> rows{};
+    std::vector<MaterialID> materials(CHUNK_BLOCK_COUNT);
+    for (const Chunk* chunk : boxChunks) {
+        const glm::ivec3 chunkCorner = Chunk::getChunkCorner(chunk->coords);
+        const glm::ivec3 localMin = glm::max(minPos - chunkCorner, glm::ivec3(0));
+        const glm::ivec3 localMax = glm::min(maxPos - chunkCorner, glm::ivec3(CHUNK_EDGE - 1));
+        rows.fill(0);
+
+        auto addBlock = [&](const glm::ivec3& localPos, const MaterialID material) {
+            materials[Chunk::getDenseIndex(localPos)] = material;
+            rows[localPos.y + localPos.z * CHUNK_EDGE] |= 1u << localPos.x;
+        };
+
+        if (chunk->storage == ChunkStorage::Dense) {
+            for (int z = localMin.z; z <= localMax.z; z++) {
+                for (int y = localMin.y; y <= localMax.y; y++) {
+                    for (int x = localMin.x; x <= localMax.x; x++) {
+                        const glm::ivec3 localPos(x, y, z);
+                        const MaterialID material = chunk->dense->getMaterial(Chunk::getDenseIndex(localPos));
+                        if (material != AIR_MATERIAL) {
+                            addBlock(localPos, material);
+                        }
+                    }
+                }
+            }
+        }
+        else {
+            Chunk::visitBoxLeaves(chunk->octree, glm::ivec3(0), localMin, localMax,
+                                  [&](const OctreeNode* blockNode, const glm::ivec3& localPos) {
+                                      addBlock(localPos, blockNode->material);
+                                  });
+        }
+
+        for (int z = localMin.z; z <= localMax.z; z++) {
+            for (int y = localMin.y; y <= localMax.y; y++) {
+                uint32_t row = rows[y + z * CHUNK_EDGE];
+                while (row != 0) {
+                    const int x = std::countr_zero(row);
+                    const MaterialID material = materials[Chunk::getDenseIndex(glm::ivec3(x, y, z))];
+                    int length = 1;
+                    while (x + length < CHUNK_EDGE && (row >> (x + length) & 1) &&
+                           materials[Chunk::getDenseIndex(glm::ivec3(x + length, y, z))] == material) {
+                        length++;
+                    }
+
+                    row &= ~(static_cast<uint32_t>((1ull << length) - 1) << x);
+                    visitor({chunkCorner + glm::ivec3(x, y, z), length, material});
+                }
+            }
+        }
+    }
+}
+
+static bool hasNoChildren(const InternalNode* node) {
+    return std::ranges::all_of(node->children, [](const OctreeNode* child) { return child == nullptr; });
+}
+
+// the faces around the block are queued before the chunk can be deleted, so the neighbours still get remeshed
+void ChunkManager::removeBlock(const glm::vec3& worldPos) {
+    Chunk* chunk = getChunk(worldPos);
+    const glm::ivec3 localPos = Chunk::getLocalPos(worldPos);
+
+    if (chunk != nullptr && chunk->storage == ChunkStorage::Dense) {
+        const int denseIndex = Chunk::getDenseIndex(localPos);
+        if (!chunk->dense->hasBlock(denseIndex)) {
+            throw std::runtime_error("error removing block!");
+        }
+        chunk->dense->setMaterial(denseIndex, AIR_MATERIAL);
+        markBlockDirty(*chunk, localPos);
+        editedColumns.insert({chunk->coords.x, chunk->coords.z});
+
+        if (chunk->dense->blockCount == 0) {
+            deleteChunk(chunk->coords);
+        }
+        return;
+    }
+
+    if (findOctreeNode(chunk, worldPos) == nullptr) {
         throw std::runtime_error("error removing block!");
     }
 
-    blockTree->block = {};
+    removeFromOctree(*chunk, localPos);
+    markBlockDirty(*chunk, localPos);
+    editedColumns.insert({chunk->coords.x, chunk->coords.z});
+
+    if (hasNoChildren(static_cast<const InternalNode*>(chunk->octree))) {
+        deleteChunk(chunk->coords);
+    }
+}
 
-    const glm::vec3 chunkCenter = Chunk::alignToChunkPos(worldPos);
+// the path is made private on the way down, then the leaf and every InternalNode it leaves without children are
+// freed on the way back up. the root is kept even when it ends up empty
+void ChunkManager::removeFromOctree(Chunk& chunk, const glm::ivec3& localPos) {
+    chunk.octree = makeNodePrivate(&chunk, chunk.octree, 0);
+    InternalNode* path[MAX_DEPTH];
+    path[0] = static_cast<InternalNode*>(chunk.octree);
 
-    if (Chunk* chunk = getChunk(chunkCenter); chunk != nullptr) {
-        chunk->geometryModified = true;
+    for (int depth = 1; depth < MAX_DEPTH; depth++) {
+        OctreeNode*& childNode = path[depth - 1]->children[Chunk::getOctantIndex(localPos, depth - 1)];
+        childNode = makeNodePrivate(&chunk, childNode, depth);
+        path[depth] = static_cast<InternalNode*>(childNode);
+    }
+
+    // the leaf itself may still be shared, nodes on the path never are by now
+    OctreeNode*& leafNode = path[MAX_DEPTH - 1]->children[Chunk::getOctantIndex(localPos, MAX_DEPTH - 1)];
+    if (leafNode->refCount > 0) {
+        octreeDag.release(leafNode, MAX_DEPTH);
+    }
+    else {
+        chunk.nodeArena.destroy(leafNode);
+    }
+    leafNode = nullptr;
+
+    for (int depth = MAX_DEPTH - 1; depth > 0; depth--) {
+        if (!hasNoChildren(path[depth])) {
+            return;
+        }
+        chunk.nodeArena.destroy(path[depth]);
+        path[depth - 1]->children[Chunk::getOctantIndex(localPos, depth - 1)] = nullptr;
     }
 }
 
 void ChunkManager::fillChunk(const glm::vec3 &worldPos, Block block) {
-    const glm::vec3 chunkCenter = Chunk::alignToChunkPos(worldPos);
+    const glm::ivec3 chunkCorner = Chunk::getChunkCorner(Chunk::getChunkCoords(worldPos));
+    fillBrush(Brush::box(chunkCorner, chunkCorner + (CHUNK_EDGE - 1)), block.color);
+}
+
+void ChunkManager::fillBrush(const Brush& brush, const uint8_t color[4]) {
+    applyBrush(brush, MaterialRegistry::getMaterialID(color), true);
+}
 
-    if (const Chunk* chunk = getChunk(chunkCenter); chunk == nullptr) {
-        createChunk(chunkCenter);
+void ChunkManager::fillGeneratedBrush(const Brush& brush, const uint8_t color[4]) {
+    applyBrush(brush, MaterialRegistry::getMaterialID(color), false);
+}
+
+void ChunkManager::clearBrush(const Brush& brush) {
+    applyBrush(brush, AIR_MATERIAL, true);
+}
+
+// only filling creates chunks, so clearing just goes through the chunks that exist
+// the solid root is shared by every chunk the brush fills entirely, and its children by the octants it fills
+void ChunkManager::applyBrush(const Brush& brush, const MaterialID material, const bool edited) {
+    const glm::ivec3 minChunk = brush.getMinBlock() >> CHUNK_EDGE_BITS;
+    const glm::ivec3 maxChunk = brush.getMaxBlock() >> CHUNK_EDGE_BITS;
+
+    if (material == AIR_MATERIAL) {
+        for (const glm::ivec3& chunkCoords : findChunksInBox(minChunk, maxChunk)) {
+            if (edited && !canEditColumn({chunkCoords.x, chunkCoords.z})) {
+                continue;
+            }
+            applyBrushToChunk(chunks.at(chunkCoords), brush, AIR_MATERIAL, nullptr, edited);
+        }
+        return;
     }
 
-    const glm::vec3 chunkCorner = chunkCenter - 3.5f;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            for (int k = 0; k < 8; k++) {
-                Block newBlock = block;
-                newBlock.position = chunkCorner + glm::vec3(i, j, k);
-                addBlock(newBlock);
+    OctreeNode* solidRoot = octreeDag.getSolidNode(material, 0);
+    for (int z = minChunk.z; z <= maxChunk.z; z++) {
+        for (int y = minChunk.y; y <= maxChunk.y; y++) {
+            for (int x = minChunk.x; x <= maxChunk.x; x++) {
+                const glm::ivec3 chunkCoords(x, y, z);
+                if (brush.getCoverage(Chunk::getChunkCorner(chunkCoords), CHUNK_EDGE) == BrushCoverage::Outside ||
+                    (edited && !canEditColumn({x, z}))) {
+                    continue;
+                }
+
+                Chunk* chunk = getChunk(chunkCoords);
+                if (chunk == nullptr) {
+                    chunk = &createChunk(chunkCoords);
+                }
+                applyBrushToChunk(*chunk, brush, material, solidRoot, edited);
             }
         }
     }
+    octreeDag.release(solidRoot, 0);
 }
 
-OctreeNode* ChunkManager::findOctreeNode(const glm::vec3& worldPos) {
-    const glm::vec3 chunkCenter = Chunk::alignToChunkPos(worldPos);
-    const Chunk* chunk = getChunk(chunkCenter);
+// the whole chunk is queued for meshing along with the borders of its neighbours, which the queue only takes once
+// however many brushes touch the chunk before the next meshAllChunks
+void ChunkManager::applyBrushToChunk(Chunk& chunk, const Brush& brush, const MaterialID material,
+                                     OctreeNode* solidRoot, const bool edited) {
+    const glm::ivec3 chunkCorner = Chunk::getChunkCorner(chunk.coords);
+    const BrushCoverage coverage = brush.getCoverage(chunkCorner, CHUNK_EDGE);
+    if (coverage == BrushCoverage::Outside) {
+        return;
+    }
+    if (edited) {
+        editedColumns.insert({chunk.coords.x, chunk.coords.z});
+    }
 
-    if (chunk == nullptr) {
+    if (coverage == BrushCoverage::Inside && material == AIR_MATERIAL) {
+        deleteChunk(chunk.coords);
+        return;
+    }
+
+    bool isEmpty;
+    if (chunk.storage == ChunkStorage::Dense) {
+        if (coverage == BrushCoverage::Inside) {
+            chunk.dense->fill(material);
+        }
+        else {
+            const glm::ivec3 localMin = glm::max(brush.getMinBlock() - chunkCorner, glm::ivec3(0));
+            const glm::ivec3 localMax = glm::min(brush.getMaxBlock() - chunkCorner, glm::ivec3(CHUNK_EDGE - 1));
+            for (int z = localMin.z; z <= localMax.z; z++) {
+                for (int y = localMin.y; y <= localMax.y; y++) {
+                    for (int x = localMin.x; x <= localMax.x; x++) {
+                        const glm::ivec3 localPos(x, y, z);
+                        if (brush.contains(chunkCorner + localPos)) {
+                            chunk.dense->setMaterial(Chunk::getDenseIndex(localPos), material);
+                        }
+                    }
+                }
+            }
+        }
+        isEmpty = chunk.dense->blockCount == 0;
+    }
+    else {
+        if (coverage == BrushCoverage::Inside) {
+            octreeDag.releaseTree(chunk.octree, 0);
+            chunk.nodeArena.release();
+            chunk.octree = octreeDag.intern(solidRoot, 0);
+        }
+        else {
+            chunk.octree = applyBrushToOctant(chunk, chunk.octree, 0, chunkCorner, brush, material, solidRoot);
+        }
+        isEmpty = hasNoChildren(static_cast<const InternalNode*>(chunk.octree));
+    }
+
+    if (isEmpty) {
+        deleteChunk(chunk.coords);
+        return;
+    }
+    markChunkDirty(chunk);
+    markNeighbourBordersDirty(chunk);
+}
+
+// returns the node that takes the octant's place, which is nullptr once the octant holds no blocks
+// solidNode is the shared node of an octant at this depth filled with the material, or nullptr when clearing
+OctreeNode* ChunkManager::applyBrushToOctant(Chunk& chunk, OctreeNode* node, const int depth,
+                                             const glm::ivec3& octantCorner, const Brush& brush,
+                                             const MaterialID material, OctreeNode* solidNode) {
+    const BrushCoverage coverage = brush.getCoverage(octantCorner, CHUNK_EDGE >> depth);
+    if (coverage == BrushCoverage::Outside || (node == nullptr && material == AIR_MATERIAL)) {
+        return node;
+    }
+
+    if (coverage == BrushCoverage::Inside) {
+        if (node != nullptr) {
+            freeSubtree(chunk, node, depth);
+        }
+        return solidNode == nullptr ? nullptr : octreeDag.intern(solidNode, depth);
+    }
+
+    // a single block is never covered partially, so this is always an InternalNode
+    auto* internalNode = static_cast<InternalNode*>(node == nullptr
+                                                        ? chunk.nodeArena.create<InternalNode>()
+                                                        : makeNodePrivate(&chunk, node, depth));
+    OctreeNode* solidChild = solidNode == nullptr ? nullptr : static_cast<InternalNode*>(solidNode)->children[0];
+    for (int i = 0; i < 8; i++) {
+        internalNode->children[i] = applyBrushToOctant(chunk, internalNode->children[i], depth + 1,
+                                                       octantCorner + Chunk::getOctantOffset(i, depth), brush,
+                                                       material, solidChild);
+    }
+
+    // the brush may have filled the rest of an octant that already held the material
+    if (solidChild != nullptr && std::ranges::all_of(internalNode->children, [&](const OctreeNode* child) {
+        return child == solidChild;
+    })) {
+        freeSubtree(chunk, internalNode, depth);
+        return octreeDag.intern(solidNode, depth);
+    }
+
+    // the root is kept even when it ends up empty
+    if (depth > 0 && hasNoChildren(internalNode)) {
+        chunk.nodeArena.destroy(internalNode);
+        return nullptr;
+    }
+    return internalNode;
+}
+
+// chunk-owned nodes go back to the chunk's arena, shared subtrees only lose the reference held to them
+void ChunkManager::freeSubtree(Chunk& chunk, OctreeNode* node, const int depth) {
+    if (node->refCount > 0) {
+        octreeDag.release(node, depth);
+        return;
+    }
+
+    if (depth == MAX_DEPTH) {
+        chunk.nodeArena.destroy(node);
+        return;
+    }
+
+    auto* internalNode = static_cast<InternalNode*>(node);
+    for (OctreeNode* child : internalNode->children) {
+        if (child != nullptr) {
+            freeSubtree(chunk, child, depth + 1);
+        }
+    }
+    chunk.nodeArena.destroy(internalNode);
+}
+
+OctreeNode* ChunkManager::findOctreeNode(const Chunk* chunk, const glm::vec3& worldPos) {
+    if (chunk == nullptr || chunk->storage != ChunkStorage::Octree) {
         return nullptr;
     }
 
-    auto* currentNode = dynamic_cast<InternalNode*>(chunk->octree);
+    const glm::ivec3 localPos = Chunk::getLocalPos(worldPos);
+    auto* currentNode = static_cast<InternalNode*>(chunk->octree);
 
     int depth = 0;
     while (depth < MAX_DEPTH) {
-        int childIndex = 0;
-        if (worldPos.x >= currentNode->block.position.x) childIndex |= 1;
-        if (worldPos.y >= currentNode->block.position.y) childIndex |= 2;
-        if (worldPos.z >= currentNode->block.position.z) childIndex |= 4;
+        const int childIndex = Chunk::getOctantIndex(localPos, depth);
 
         if (currentNode->children[childIndex] == nullptr) {
             return nullptr;
@@ -227,29 +969,211 @@ OctreeNode* ChunkManager::findOctreeNode(const glm::vec3& worldPos) {
             return currentNode->children[childIndex];
         }
 
-        currentNode = dynamic_cast<InternalNode*>(currentNode->children[childIndex]);
+        currentNode = static_cast<InternalNode*>(currentNode->children[childIndex]);
         depth++;
     }
 
     return currentNode;
 }
 
+void ChunkManager::markChunkDirty(Chunk& chunk) {
+    markSlicesDirty(chunk, ALL_CHUNK_SLICES);
+}
+
+// a face of the edited block can change, and so can the face of the block behind it that points at it
+// for each face that is the edited block's own layer and the layer behind it, which may be in the neighbour
+void ChunkManager::markBlockDirty(Chunk& chunk, const glm::ivec3& localPos) {
+    SliceMask slices{};
+    for (int face = 0; face < 6; face++) {
+        const int axis = ChunkMesher::getFaceAxis(face);
+        const int behindLayer = localPos[axis] + (ChunkMesher::isPositiveFace(face) ? -1 : 1);
+        slices[face] |= 1u << localPos[axis];
+
+        if (behindLayer >= 0 && behindLayer < CHUNK_EDGE) {
+            slices[face] |= 1u << behindLayer;
+            continue;
+        }
+
+        glm::ivec3 neighbourOffset(0);
+        neighbourOffset[axis] = behindLayer < 0 ? -1 : 1;
+        if (Chunk* neighbour = getChunk(chunk.coords + neighbourOffset); neighbour != nullptr) {
+            SliceMask neighbourSlices{};
+            neighbourSlices[face] = 1u << (behindLayer & CHUNK_EDGE_MASK);
+            markSlicesDirty(*neighbour, neighbourSlices);
+        }
+    }
+    markSlicesDirty(chunk, slices);
+}
+
+// for bulk changes: the border layer of each neighbour, on the faces that point into this chunk
+void ChunkManager::markNeighbourBordersDirty(const Chunk& chunk) {
+    for (int face = 0; face < 6; face++) {
+        const bool positiveFace = ChunkMesher::isPositiveFace(face);
+        glm::ivec3 neighbourOffset(0);
+        neighbourOffset[ChunkMesher::getFaceAxis(face)] = positiveFace ? -1 : 1;
+
+        if (Chunk* neighbour = getChunk(chunk.coords + neighbourOffset); neighbour != nullptr) {
+            SliceMask neighbourSlices{};
+            neighbourSlices[face] = 1u << (positiveFace ? CHUNK_EDGE - 1 : 0);
+            markSlicesDirty(*neighbour, neighbourSlices);
+        }
+    }
+}
+
+// chunks can be queued from the thread pool while terrain tiles are filled, and a tile can queue a neighbouring
+// tile's chunk, so the flags are only touched with the queue locked
+void ChunkManager::markSlicesDirty(Chunk& chunk, const SliceMask& slices) {
+    std::lock_guard lock(dirtyChunksMutex);
+    for (int face = 0; face < 6; face++) {
+        chunk.dirtySlices[face] |= slices[face];
+    }
+
+    if (!chunk.geometryModified) {
+        chunk.geometryModified = true;
+        dirtyChunks.push_back(chunk.coords);
+    }
+}
+
+// chunks are meshed on the thread pool into their own buffers, then handed to the vertex pool on this thread
+// the queue holds coordinates rather than pointers, so a chunk that was deleted after being queued is skipped,
+// and the flag is cleared as chunks are taken so one that was deleted and queued again is only meshed once
 void ChunkManager::meshAllChunks() {
-    for (auto& [pos, chunk] : chunks) {
-        if (chunk.geometryModified) {
-            TimeManager::startTimer("meshChunk");
-            meshChunk(chunk);
-            TimeManager::addTimeToProfiler("meshChunk", TimeManager::finishTimer("meshChunk"));
+    if (dirtyChunks.empty()) {
+        return;
+    }
+
+    std::vector<Chunk*> modifiedChunks;
+    modifiedChunks.reserve(dirtyChunks.size());
+    for (const glm::ivec3& chunkCoords : dirtyChunks) {
+        if (Chunk* chunk = getChunk(chunkCoords); chunk != nullptr && chunk->geometryModified) {
+            chunk->geometryModified = false;
+            modifiedChunks.push_back(chunk);
+        }
+    }
+    dirtyChunks.clear();
 
-            TimeManager::startTimer("addToVertexPool");
-            if (!chunk.vertices.empty()) {
-                VertexPool::addToVertexPool(chunk.vertices, chunk.indices, chunk.ID);
+    std::vector<MeshStats> meshStats(modifiedChunks.size());
+    TimeManager::startTimer("meshChunk");
+    ThreadPool::parallelFor(modifiedChunks.size(), [&](const size_t i) {
+        meshStats[i] = meshChunk(*modifiedChunks[i]);
+    });
+    TimeManager::addTimeToProfiler("meshChunk", TimeManager::finishTimer("meshChunk"));
+
+    TimeManager::startTimer("addToVertexPool");
+    for (size_t i = 0; i < modifiedChunks.size(); i++) {
+        uploadMesh(*modifiedChunks[i]);
+        TimeManager::addCountToProfiler("quads before merging", meshStats[i].faceCount);
+        TimeManager::addCountToProfiler("quads after merging", meshStats[i].quadCount);
+    }
+    TimeManager::addTimeToProfiler("addToVertexPool", TimeManager::finishTimer("addToVertexPool"));
+}
+
+void ChunkManager::setLodDistance(const float distance) {
+    lodDistance = distance;
+    lodCameraChunk.reset();
+    if (lodDistance > 0.0f) {
+        return;
+    }
+
+    for (auto& [chunkCoords, chunk] : chunks) {
+        if (chunk.lodLevel != 0) {
+            chunk.lodLevel = 0;
+            markChunkDirty(chunk);
+        }
+    }
+}
+
+// levels are only picked again once the camera enters another chunk. which of a chunk's faces its neighbours hide
+// depends on the level they are meshed at, so neighbours below full resolution are meshed again as well
+void ChunkManager::updateLodLevels(const glm::vec3& cameraPosition) {
+    const glm::ivec3 cameraChunk = Chunk::getChunkCoords(cameraPosition);
+    if (lodDistance <= 0.0f || lodCameraChunk == cameraChunk) {
+        return;
+    }
+    lodCameraChunk = cameraChunk;
+    lodCameraPosition = cameraPosition;
+
+    std::vector<Chunk*> changedChunks;
+    for (auto& [chunkCoords, chunk] : chunks) {
+        if (const int lodLevel = selectLodLevel(chunk); lodLevel != chunk.lodLevel) {
+            chunk.lodLevel = lodLevel;
+            changedChunks.push_back(&chunk);
+        }
+    }
+
+    for (Chunk* chunk : changedChunks) {
+        markChunkDirty(*chunk);
+        for (const glm::ivec3& offset : neighbourOffsets) {
+            if (Chunk* neighbour = getChunk(chunk->coords + offset); neighbour != nullptr && neighbour->lodLevel > 0) {
+                markChunkDirty(*neighbour);
             }
-            TimeManager::addTimeToProfiler("addToVertexPool", TimeManager::finishTimer("addToVertexPool"));
         }
     }
 }
 
+// level L starts at lodDistance * 2^(L - 1) blocks from the camera, but a chunk has to be a chunk's width past
+// that distance before it switches, so moving back and forth around it doesn't remesh the chunk every time
+int ChunkManager::selectLodLevel(const Chunk& chunk) const {
+    const glm::vec3 chunkCenter = glm::vec3(Chunk::getChunkCorner(chunk.coords)) + CHUNK_EDGE * 0.5f;
+    const float distance = glm::length(chunkCenter - lodCameraPosition);
+    auto getLodStart = [this](const int lodLevel) {
+        return lodDistance * static_cast<float>(1 << (lodLevel - 1));
+    };
+
+    int lodLevel = chunk.lodLevel;
+    while (lodLevel < MAX_LOD_LEVEL && distance > getLodStart(lodLevel + 1) + CHUNK_EDGE) {
+        lodLevel++;
+    }
+    while (lodLevel > 0 && distance < getLodStart(lodLevel) - CHUNK_EDGE) {
+        lodLevel--;
+    }
+    return lodLevel;
+}
+
+void ChunkManager::uploadMesh(const Chunk& chunk) {
+    if (!chunk.vertices.empty()) {
+        VertexPool::addToVertexPool(chunk.vertices, chunk.indices, chunk.ID, chunk.firstModifiedVertex,
+                                    chunk.firstModifiedIndex);
+    }
+    else {
+        VertexPool::removeFromVertexPool(chunk.ID);
+    }
+}
+
 uint32_t ChunkManager::chunkCount() const {
     return chunks.size();
 }
+
+uint64_t ChunkManager::octreeNodeCount() const {
+    uint64_t nodeCount = octreeDag.getNodeCount();
+    for (const auto& [pos, chunk] : chunks) {
+        nodeCount += chunk.nodeArena.getNodeCount();
+    }
+    return nodeCount;
+}
+
+size_t ChunkManager::octreeMemoryUsage() const {
+    size_t memoryUsage = octreeDag.getReservedBytes();
+    for (const auto& [pos, chunk] : chunks) {
+        memoryUsage += chunk.nodeArena.getReservedBytes();
+    }
+    return memoryUsage;
+}
+
+// moves the chunk's whole octree into the shared DAG, after which the chunk's arena holds nothing
+void ChunkManager::compressChunk(Chunk& chunk) {
+    if (chunk.storage != ChunkStorage::Octree || chunk.octree->refCount > 0) {
+        return;
+    }
+
+    OctreeNode* sharedRoot = octreeDag.intern(chunk.octree, 0);
+    octreeDag.releaseTree(chunk.octree, 0);
+    chunk.nodeArena.release();
+    chunk.octree = sharedRoot;
+}
+
+void ChunkManager::compressAllChunks() {
+    for (auto& [pos, chunk] : chunks) {
+        compressChunk(chunk);
+    }
+}
@@ -1,55 +1,207 @@
 #ifndef CHUNKMANAGER_H
 #define CHUNKMANAGER_H
 
+#include <span>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <functional>
+#include <mutex>
+#include <optional>
 #include <glm/glm.hpp>
 
 #include "Block.h"
+#include "Brush.h"
 #include "Chunk.h"
+#include "ChunkMesher.h"
+#include "ChunkSnapshot.h"
+#include "OctreeDag.h"
 
-// hash function for vec3s so they can be used in the unordered map of ChunkManager
+// hash function for chunk coordinates so they can be used in the unordered map of ChunkManager
+// the coordinates are packed into 64 bits (21 bits per axis) and mixed with the splitmix64 finalizer,
+// so permutations and neighbouring chunks don't collide or cluster into the same buckets
 template<>
-struct std::hash<glm::vec3> {
-    std::size_t operator()(const glm::vec3 &v) const noexcept {
-        return std::hash<float>()(v.x) ^
-               std::hash<float>()(v.y) ^
-               std::hash<float>()(v.z);
+struct std::hash<glm::ivec3> {
+    std::size_t operator()(const glm::ivec3 &v) const noexcept {
+        constexpr uint64_t axisMask = (1ull << 21) - 1;
+        uint64_t key = (static_cast<uint64_t>(v.x) & axisMask) |
+                       (static_cast<uint64_t>(v.y) & axisMask) << 21 |
+                       (static_cast<uint64_t>(v.z) & axisMask) << 42;
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        key ^= key >> 31;
+        return key;
     }
 };
 
+// chunk columns are keyed by their x and z chunk coordinates
+template<>
+struct std::hash<glm::ivec2> {
+    std::size_t operator()(const glm::ivec2 &v) const noexcept {
+        return std::hash<glm::ivec3>()({v.x, 0, v.y});
+    }
+};
+
+// a block waiting to be inserted by ChunkManager::addBlocks
+struct PendingBlock {
+    glm::ivec3 chunkCoords;
+    uint32_t mortonIndex;
+    MaterialID material;
+};
+
+// the first block a ray runs into, normal points out of the face it entered through and is zero if the ray started
+// inside the block. distance is measured along the ray from its origin
+struct RaycastHit {
+    glm::ivec3 blockPos;
+    glm::ivec3 normal;
+    float distance;
+    MaterialID material;
+};
+
+// blocks from start to start + (length - 1, 0, 0) that all have the same material
+struct RegionRun {
+    glm::ivec3 start;
+    int length;
+    MaterialID material;
+};
+
+using RegionVisitor = std::function<void(const RegionRun &run)>;
+
 class ChunkManager {
 public:
-    std::unordered_map<glm::vec3, Chunk> chunks;
+    OctreeDag octreeDag;
+    std::unordered_map<glm::ivec3, Chunk> chunks;
+    // columns changed by addBlock, removeBlock or a brush, these differ from the generated terrain and need saving
+    std::unordered_set<glm::ivec2> editedColumns;
+    // set while terrain is streamed, addBlock and brushes leave columns it returns false for untouched, since their
+    // terrain would later be inserted over the edits. unset, every column can be edited
+    std::function<bool(const glm::ivec2 &column)> isColumnEditable;
     static uint32_t currentID;
 
     Chunk *getChunk(const glm::vec3 &worldPos);
 
-    void createChunk(const glm::vec3 &worldPos);
+    Chunk *getChunk(const glm::ivec3 &chunkCoords);
+
+    Chunk &createChunk(const glm::ivec3 &chunkCoords, ChunkStorage storage = DEFAULT_CHUNK_STORAGE);
+
+    // drops the chunk along with its references into the octree DAG and its vertex pool ranges, the neighbours'
+    // faces towards it are queued to be meshed again
+    void deleteChunk(const glm::ivec3 &chunkCoords);
 
     void fillChunk(const glm::vec3 &worldPos, Block block);
 
-    void meshChunk(Chunk &chunk);
+    // sets every block inside the brush to the color, creating chunks as needed
+    void fillBrush(const Brush &brush, const uint8_t color[4]);
+
+    // like fillBrush, but for generated terrain, whose columns aren't marked as edited and so aren't saved
+    void fillGeneratedBrush(const Brush &brush, const uint8_t color[4]);
+
+    // removes every block inside the brush, chunks left without blocks are deleted
+    void clearBrush(const Brush &brush);
+
+    // a buried chunk is cleared instead, it has no visible faces
+    MeshStats meshChunk(Chunk &chunk) const;
+
+    [[nodiscard]] bool isBuried(const Chunk &chunk) const;
+
+    ChunkSnapshot createSnapshot(const Chunk &chunk) const;
 
+    // queues the whole chunk to be remeshed by the next meshAllChunks, a chunk is only queued once until then
+    void markChunkDirty(Chunk &chunk);
+
+    // queues only the slices whose faces a change to the block at localPos can affect, including the slice of a
+    // neighbouring chunk when the block is on the border
+    void markBlockDirty(Chunk &chunk, const glm::ivec3 &localPos);
+
+    // remeshes the queued chunks only, so the cost depends on how much was edited rather than on the world size
     void meshAllChunks();
 
+    // chunks further than distance blocks from the camera are meshed with one voxel per 2x2x2 blocks, and ones
+    // further than twice that with one voxel per 4x4x4 blocks. 0 meshes every chunk at full resolution
+    void setLodDistance(float distance);
+
+    // picks each chunk's level of detail for the camera position, chunks whose level changed are queued for meshing
+    void updateLodLevels(const glm::vec3 &cameraPosition);
+
+    // hands the chunk's mesh to the vertex pool, or releases its ranges if the mesh is empty
+    static void uploadMesh(const Chunk &chunk);
+
     uint32_t chunkCount() const;
 
+    uint64_t octreeNodeCount() const;
+
+    size_t octreeMemoryUsage() const;
+
+    void compressChunk(Chunk &chunk);
+
+    void compressAllChunks();
+
     void addBlock(const Block &block);
 
-    static OctreeNode *createPathToBlock(const Chunk *chunk, const Block &block);
+    void addBlocks(std::span<const Block> blocks);
+
+    // fills a new chunk whose mesh is restored along with its blocks, so nothing is queued for meshing
+    // only touches the chunk itself, so different chunks can be restored at the same time
+    void restoreChunk(Chunk &chunk, std::span<const PendingBlock> blocks);
+
+    OctreeNode *createPathToBlock(Chunk *chunk, const Block &block);
 
     Block getBlock(const glm::vec3 &worldPos);
 
     bool hasBlock(const glm::vec3 &worldPos);
 
-    void removeBlock(const glm::vec3 &worldPos);
+    // walks the ray through the largest empty cell around each point instead of block by block: a missing chunk is
+    // crossed in one step and so is every empty octant. only reads the chunk map, so rays can be cast in parallel
+    [[nodiscard]] std::optional<RaycastHit> raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                                                    float maxDistance) const;
+
+    // calls visitor with every run of blocks inside the box from minPos to maxPos, both inclusive
+    // each touched chunk is looked up once and missing chunks and empty octants are skipped without visiting their
+    // blocks. chunks are visited in z, y, x order, and within a chunk runs go along x, then by row in y, then z
+    void visitRegion(const glm::ivec3 &minPos, const glm::ivec3 &maxPos, const RegionVisitor &visitor) const;
 
-    void generateBlockMesh(Chunk &chunk, Block &block, std::array<bool, 6> &facesToDraw);
+    // frees the block's leaf and any nodes left empty by it, and deletes the chunk once it has no blocks
+    void removeBlock(const glm::vec3 &worldPos);
 
 private:
-    OctreeNode *findOctreeNode(const glm::vec3 &worldPos);
+    [[nodiscard]] bool canEditColumn(const glm::ivec2 &column) const;
+
+    std::vector<glm::ivec3> dirtyChunks;
+    std::mutex dirtyChunksMutex;
+    float lodDistance = 0.0f;
+    // the camera chunk and position the levels of detail were last picked for
+    std::optional<glm::ivec3> lodCameraChunk;
+    glm::vec3 lodCameraPosition{};
+
+    [[nodiscard]] int selectLodLevel(const Chunk &chunk) const;
+
+    void markSlicesDirty(Chunk &chunk, const SliceMask &slices);
+
+    void markNeighbourBordersDirty(const Chunk &chunk);
+
+    void insertIntoChunk(Chunk &chunk, std::span<const PendingBlock> blocks);
+
+    // the coordinates of the chunks that exist between minChunk and maxChunk, both inclusive, in z, y, x order
+    [[nodiscard]] std::vector<glm::ivec3> findChunksInBox(const glm::ivec3 &minChunk, const glm::ivec3 &maxChunk) const;
+
+    // edited chunks have their columns added to editedColumns
+    void applyBrush(const Brush &brush, MaterialID material, bool edited);
+
+    void applyBrushToChunk(Chunk &chunk, const Brush &brush, MaterialID material, OctreeNode *solidRoot,
+                           bool edited);
+
+    OctreeNode *applyBrushToOctant(Chunk &chunk, OctreeNode *node, int depth, const glm::ivec3 &octantCorner,
+                                   const Brush &brush, MaterialID material, OctreeNode *solidNode);
+
+    void freeSubtree(Chunk &chunk, OctreeNode *node, int depth);
+
+    OctreeNode *makeNodePrivate(Chunk *chunk, OctreeNode *node, int depth);
+
+    void removeFromOctree(Chunk &chunk, const glm::ivec3 &localPos);
+
+    static OctreeNode *findOctreeNode(const Chunk *chunk, const glm::vec3 &worldPos);
 };
 
 #endif //CHUNKMANAGER_H
@@ -0,0 +1,205 @@
+#include "ChunkMesher.h"
+
+#include <bit>
+
+#include "Chunk.h"
+#include "../util/VertexUtil.h"
+
+#ifdef VOXEL_GREEDY_MESHING
+MeshingMode MESHING_MODE = MeshingMode::Greedy;
+#else
+MeshingMode MESHING_MODE = MeshingMode::Culled;
+#endif
+
+// step between neighbouring blocks along each axis of ChunkSnapshot::materials
+static constexpr std::array<int, 3> paddedStrides = {
+    1, ChunkSnapshot::PADDED_EDGE, ChunkSnapshot::PADDED_EDGE * ChunkSnapshot::PADDED_EDGE
+};
+
+MeshStats ChunkMesher::meshSnapshot(const ChunkSnapshot &snapshot, std::vector<ChunkVertex> &vertices,
+                                    std::vector<uint32_t> &indices, const MeshingMode mode) {
+    SliceQuadCounts sliceQuadCounts;
+    return meshSlices(snapshot, ALL_CHUNK_SLICES, vertices, indices, sliceQuadCounts, mode);
+}
+
+MeshStats ChunkMesher::meshSlices(const ChunkSnapshot &snapshot, const SliceMask &slices,
+                                  std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices,
+                                  SliceQuadCounts &sliceQuadCounts, const MeshingMode mode) {
+    FaceMasks masks;
+    buildFaceMasks(snapshot, masks);
+
+    MeshStats stats;
+    SliceRows rows;
+    for (int face = 0; face < 6; face++) {
+        for (const ColumnMask faceMask : masks.faces[face]) {
+            stats.faceCount += std::popcount(faceMask & slices[face]);
+        }
+
+        for (int layer = 0; layer < CHUNK_EDGE; layer++) {
+            if ((slices[face] >> layer & 1) == 0) {
+                continue;
+            }
+
+            getSliceRows(masks, face, layer, rows);
+            const uint32_t quadCount = mode == MeshingMode::Greedy
+                                           ? insertGreedyQuads(snapshot, face, layer, rows, vertices, indices)
+                                           : insertCulledQuads(snapshot, face, layer, rows, vertices, indices);
+            sliceQuadCounts[face * CHUNK_EDGE + layer] = static_cast<uint16_t>(quadCount);
+            stats.quadCount += quadCount;
+        }
+    }
+
+    return stats;
+}
+
+void ChunkMesher::buildFaceMasks(const ChunkSnapshot &snapshot, FaceMasks &masks) {
+    // gather each column from the snapshot, including the neighbour's block at both ends
+    // at a lower level of detail the columns outside the used part of the snapshot are left empty
+    const int lodEdge = snapshot.getLodEdge();
+    for (int axis = 0; axis < 3; axis++) {
+        const int stride = paddedStrides[axis];
+        const int uStride = paddedStrides[(axis + 1) % 3];
+        const int vStride = paddedStrides[(axis + 2) % 3];
+
+        for (int v = 0; v < CHUNK_EDGE; v++) {
+            for (int u = 0; u < CHUNK_EDGE; u++) {
+                if (u >= lodEdge || v >= lodEdge) {
+                    masks.occupancy[axis][u + v * CHUNK_EDGE] = 0;
+                    continue;
+                }
+
+                const MaterialID *materials = &snapshot.materials[(u + 1) * uStride + (v + 1) * vStride];
+                ColumnMask column = 0;
+                for (int i = 0; i < ChunkSnapshot::PADDED_EDGE; i++) {
+                    column |= static_cast<ColumnMask>(materials[i * stride] != AIR_MATERIAL) << i;
+                }
+                masks.occupancy[axis][u + v * CHUNK_EDGE] = column;
+            }
+        }
+    }
+
+    // a face is visible where a block is followed by air, the padding bits are dropped afterwards
+    // these are plain loops over 64 bit words, which the compiler vectorises where the target allows it
+    const ColumnMask interiorMask = (static_cast<ColumnMask>(1) << lodEdge) - 1;
+    for (int face = 0; face < 6; face++) {
+        const auto &columns = masks.occupancy[getFaceAxis(face)];
+        auto &faceColumns = masks.faces[face];
+
+        if (isPositiveFace(face)) {
+            for (int i = 0; i < CHUNK_COLUMN_COUNT; i++) {
+                faceColumns[i] = (columns[i] & ~(columns[i] >> 1)) >> 1 & interiorMask;
+            }
+        }
+        else {
+            for (int i = 0; i < CHUNK_COLUMN_COUNT; i++) {
+                faceColumns[i] = (columns[i] & ~(columns[i] << 1)) >> 1 & interiorMask;
+            }
+        }
+    }
+}
+
+// bit u of rows[v] is set if the block at (u, v) in this layer shows this face
+void ChunkMesher::getSliceRows(const FaceMasks &masks, const int face, const int layer, SliceRows &rows) {
+    for (int v = 0; v < CHUNK_EDGE; v++) {
+        ColumnMask row = 0;
+        for (int u = 0; u < CHUNK_EDGE; u++) {
+            row |= (masks.faces[face][u + v * CHUNK_EDGE] >> layer & 1) << u;
+        }
+        rows[v] = row;
+    }
+}
+
+uint32_t ChunkMesher::insertCulledQuads(const ChunkSnapshot &snapshot, const int face, const int layer,
+                                        SliceRows &rows, std::vector<ChunkVertex> &vertices,
+                                        std::vector<uint32_t> &indices) {
+    const glm::ivec3 chunkCorner = Chunk::getChunkCorner(snapshot.coords);
+    const int axis = getFaceAxis(face);
+    const int voxelSize = 1 << snapshot.lodLevel;
+    uint32_t quadCount = 0;
+
+    for (int v = 0; v < CHUNK_EDGE; v++) {
+        while (rows[v] != 0) {
+            const glm::ivec3 localPos = getSlicePos(axis, layer, std::countr_zero(rows[v]), v);
+            rows[v] &= rows[v] - 1;
+
+            const Material &material = MaterialRegistry::getMaterial(snapshot.getMaterial(localPos));
+            insertBlockFace(vertices, indices, face, glm::vec3(chunkCorner + localPos * voxelSize), material.color,
+                            glm::vec3(static_cast<float>(voxelSize)));
+            quadCount++;
+        }
+    }
+
+    return quadCount;
+}
+
+// a layer of blocks facing the same way is covered with rectangles: a run of same colored faces is taken
+// along u, then grown along v for as long as the next row has the same run
+uint32_t ChunkMesher::insertGreedyQuads(const ChunkSnapshot &snapshot, const int face, const int layer,
+                                        SliceRows &rows, std::vector<ChunkVertex> &vertices,
+                                        std::vector<uint32_t> &indices) {
+    const glm::ivec3 chunkCorner = Chunk::getChunkCorner(snapshot.coords);
+    const int axis = getFaceAxis(face);
+    const int voxelSize = 1 << snapshot.lodLevel;
+    uint32_t quadCount = 0;
+
+    for (int v = 0; v < CHUNK_EDGE; v++) {
+        while (rows[v] != 0) {
+            const int u = std::countr_zero(rows[v]);
+            const MaterialID material = snapshot.getMaterial(getSlicePos(axis, layer, u, v));
+
+            auto matchesMaterial = [&](const int runU, const int runV) {
+                return snapshot.getMaterial(getSlicePos(axis, layer, runU, runV)) == material;
+            };
+
+            int width = 1;
+            while (u + width < CHUNK_EDGE && (rows[v] >> (u + width) & 1) && matchesMaterial(u + width, v)) {
+                width++;
+            }
+
+            const ColumnMask runMask = ((static_cast<ColumnMask>(1) << width) - 1) << u;
+            int height = 1;
+            while (v + height < CHUNK_EDGE && (rows[v + height] & runMask) == runMask) {
+                bool sameMaterial = true;
+                for (int i = 0; i < width && sameMaterial; i++) {
+                    sameMaterial = matchesMaterial(u + i, v + height);
+                }
+                if (!sameMaterial) {
+                    break;
+                }
+                height++;
+            }
+
+            for (int i = 0; i < height; i++) {
+                rows[v + i] &= ~runMask;
+            }
+
+            glm::vec3 faceSize(static_cast<float>(voxelSize));
+            faceSize[(axis + 1) % 3] = static_cast<float>(width * voxelSize);
+            faceSize[(axis + 2) % 3] = static_cast<float>(height * voxelSize);
+            insertBlockFace(vertices, indices, face,
+                            glm::vec3(chunkCorner + getSlicePos(axis, layer, u, v) * voxelSize),
+                            MaterialRegistry::getMaterial(material).color, faceSize);
+            quadCount++;
+        }
+    }
+
+    return quadCount;
+}
+
+glm::ivec3 ChunkMesher::getSlicePos(const int axis, const int layer, const int u, const int v) {
+    glm::ivec3 localPos(0);
+    localPos[axis] = layer;
+    localPos[(axis + 1) % 3] = u;
+    localPos[(axis + 2) % 3] = v;
+    return localPos;
+}
+
+int ChunkMesher::getFaceAxis(const int face) {
+    constexpr std::array<int, 6> faceAxes = {1, 1, 2, 2, 0, 0};
+    return faceAxes[face];
+}
+
+bool ChunkMesher::isPositiveFace(const int face) {
+    constexpr std::array<bool, 6> positiveFaces = {true, false, true, false, false, true};
+    return positiveFaces[face];
+}
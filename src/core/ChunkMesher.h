@@ -0,0 +1,73 @@
+#ifndef CHUNKMESHER_H
+#define CHUNKMESHER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ChunkSnapshot.h"
+#include "../rendering/scene/Vertex.h"
+
+// one bit per block along a line through the padded chunk, bit i is the block at local position i - 1
+using ColumnMask = uint64_t;
+
+static_assert(ChunkSnapshot::PADDED_EDGE <= 64, "padded chunk columns must fit into a ColumnMask");
+
+constexpr int CHUNK_COLUMN_COUNT = CHUNK_EDGE * CHUNK_EDGE;
+
+// culled meshing emits a quad per visible face, greedy meshing merges neighbouring faces of the same color first
+enum class MeshingMode : uint8_t {
+    Culled,
+    Greedy
+};
+
+extern MeshingMode MESHING_MODE;
+
+// bump whenever the quads produced for the same blocks change, saved meshes with another version are rebuilt
+constexpr uint32_t MESH_FORMAT_VERSION = 1;
+
+struct MeshStats {
+    uint32_t faceCount = 0;
+    uint32_t quadCount = 0;
+};
+
+// faces are in the same order as in insertBlockFace: top, bottom, front, back, left, right
+// column c of an axis runs along it at (u, v) = (c % CHUNK_EDGE, c / CHUNK_EDGE) on the other two axes, in order
+struct FaceMasks {
+    std::array<std::array<ColumnMask, CHUNK_COLUMN_COUNT>, 3> occupancy;
+    std::array<std::array<ColumnMask, CHUNK_COLUMN_COUNT>, 6> faces;
+};
+
+// turns a snapshot into quads, the visible faces of a whole column are found with a shift and an and-not
+// quads come out slice by slice, so a single slice can be meshed again and swapped into an existing mesh
+class ChunkMesher {
+public:
+    static MeshStats meshSnapshot(const ChunkSnapshot &snapshot, std::vector<ChunkVertex> &vertices,
+                                  std::vector<uint32_t> &indices, MeshingMode mode = MESHING_MODE);
+
+    // only meshes the selected slices, the quad count of each is written to sliceQuadCounts
+    static MeshStats meshSlices(const ChunkSnapshot &snapshot, const SliceMask &slices,
+                                std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices,
+                                SliceQuadCounts &sliceQuadCounts, MeshingMode mode = MESHING_MODE);
+
+    static void buildFaceMasks(const ChunkSnapshot &snapshot, FaceMasks &masks);
+
+    static int getFaceAxis(int face);
+
+    static bool isPositiveFace(int face);
+
+private:
+    using SliceRows = std::array<ColumnMask, CHUNK_EDGE>;
+
+    static void getSliceRows(const FaceMasks &masks, int face, int layer, SliceRows &rows);
+
+    static uint32_t insertCulledQuads(const ChunkSnapshot &snapshot, int face, int layer, SliceRows &rows,
+                                      std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices);
+
+    static uint32_t insertGreedyQuads(const ChunkSnapshot &snapshot, int face, int layer, SliceRows &rows,
+                                      std::vector<ChunkVertex> &vertices, std::vector<uint32_t> &indices);
+
+    static glm::ivec3 getSlicePos(int axis, int layer, int u, int v);
+};
+
+#endif //CHUNKMESHER_H
@@ -0,0 +1,44 @@
+#ifndef CHUNKSNAPSHOT_H
+#define CHUNKSNAPSHOT_H
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ChunkGeometry.h"
+#include "MaterialRegistry.h"
+
+// a copy of one chunk's materials plus a one block border taken from its six face neighbours
+// meshing only reads from the snapshot, so it never touches the chunk map and can run off the main thread
+struct ChunkSnapshot {
+    static constexpr int PADDED_EDGE = CHUNK_EDGE + 2;
+    static constexpr int PADDED_BLOCK_COUNT = PADDED_EDGE * PADDED_EDGE * PADDED_EDGE;
+
+    glm::ivec3 coords{};
+    // at level of detail L only the first CHUNK_EDGE >> L positions along each axis are used, each one voxel
+    // standing for 2^L blocks along each axis, and the padding is the layer around those
+    int lodLevel = 0;
+    std::vector<MaterialID> materials = std::vector<MaterialID>(PADDED_BLOCK_COUNT, AIR_MATERIAL);
+
+    // local positions range from -1 to CHUNK_EDGE, the outermost layer belongs to the neighbours
+    static int getPaddedIndex(const glm::ivec3 &localPos) {
+        return (localPos.x + 1) + (localPos.y + 1) * PADDED_EDGE + (localPos.z + 1) * PADDED_EDGE * PADDED_EDGE;
+    }
+
+    [[nodiscard]] int getLodEdge() const {
+        return CHUNK_EDGE >> lodLevel;
+    }
+
+    [[nodiscard]] MaterialID getMaterial(const glm::ivec3 &localPos) const {
+        return materials[getPaddedIndex(localPos)];
+    }
+
+    [[nodiscard]] bool hasBlock(const glm::ivec3 &localPos) const {
+        return getMaterial(localPos) != AIR_MATERIAL;
+    }
+
+    void setMaterial(const glm::ivec3 &localPos, const MaterialID material) {
+        materials[getPaddedIndex(localPos)] = material;
+    }
+};
+
+#endif //CHUNKSNAPSHOT_H
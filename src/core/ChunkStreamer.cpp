@@ -0,0 +1,151 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+ChunkStreamer::ChunkStreamer(ChunkManager &chunkManager, ColumnGenerator generateColumn, ColumnSaver saveColumns,
+                             const int viewDistance)
+    : chunkManager(chunkManager), generateColumn(std::move(generateColumn)), saveColumns(std::move(saveColumns)),
+      columnRadius((viewDistance + CHUNK_EDGE - 1) >> CHUNK_EDGE_BITS),
+      streamingThread([this](const std::stop_token &stopToken) { streamColumns(stopToken); }) {
+    this->chunkManager.isColumnEditable = [this](const glm::ivec2 &column) { return isResident(column); };
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    chunkManager.isColumnEditable = nullptr;
+}
+
+void ChunkStreamer::update(const glm::vec3 &cameraPosition) {
+    const glm::ivec3 cameraChunk = Chunk::getChunkCoords(cameraPosition);
+    const glm::ivec2 newCameraColumn(cameraChunk.x, cameraChunk.z);
+    if (!started || newCameraColumn != cameraColumn) {
+        started = true;
+        cameraColumn = newCameraColumn;
+        evictDistantColumns();
+        requestNearbyColumns();
+    }
+
+    std::vector<StreamedColumn> readyColumns;
+    {
+        std::lock_guard lock(queueMutex);
+        const size_t readyCount = std::min<size_t>(finishedColumns.size(), MAX_COLUMNS_PER_UPDATE);
+        readyColumns.assign(std::make_move_iterator(finishedColumns.begin()),
+                            std::make_move_iterator(finishedColumns.begin() + readyCount));
+        finishedColumns.erase(finishedColumns.begin(), finishedColumns.begin() + readyCount);
+    }
+
+    // a column that was evicted or already inserted while it was being generated is dropped
+    for (StreamedColumn &streamedColumn: readyColumns) {
+        const auto it = columns.find(streamedColumn.column);
+        if (it == columns.end() || it->second != ColumnState::Pending) {
+            continue;
+        }
+        chunkManager.addBlocks(streamedColumn.blocks);
+        it->second = ColumnState::Resident;
+    }
+}
+
+uint32_t ChunkStreamer::residentColumnCount() const {
+    return std::ranges::count(columns | std::views::values, ColumnState::Resident);
+}
+
+uint32_t ChunkStreamer::pendingColumnCount() const {
+    return std::ranges::count(columns | std::views::values, ColumnState::Pending);
+}
+
+void ChunkStreamer::streamColumns(const std::stop_token &stopToken) {
+    while (true) {
+        glm::ivec2 column;
+        {
+            std::unique_lock lock(queueMutex);
+            if (!requestReady.wait(lock, stopToken, [this] { return !requests.empty(); })) {
+                return;
+            }
+            column = requests.back();
+            requests.pop_back();
+        }
+
+        std::vector<Block> blocks = generateColumn(column);
+
+        std::lock_guard lock(queueMutex);
+        finishedColumns.push_back({column, std::move(blocks)});
+    }
+}
+
+// every chunk is checked rather than only the streamed columns, so blocks placed outside the terrain go as well
+// only resident columns are handed to the saver, even when they no longer have any chunks, emptying one is an edit
+// too. any other column is missing its terrain, saving it would replace that terrain for good, so its edits are
+// dropped instead
+void ChunkStreamer::evictDistantColumns() {
+    std::vector<glm::ivec2> evictedColumns;
+    std::erase_if(columns, [&](const auto &entry) {
+        if (isInRadius(entry.first, columnRadius + 1)) {
+            return false;
+        }
+        if (entry.second == ColumnState::Resident) {
+            evictedColumns.push_back(entry.first);
+        }
+        return true;
+    });
+
+    std::vector<glm::ivec3> distantChunks;
+    for (const auto &[chunkCoords, chunk]: chunkManager.chunks) {
+        if (!isInRadius({chunkCoords.x, chunkCoords.z}, columnRadius + 1)) {
+            distantChunks.push_back(chunkCoords);
+        }
+    }
+
+    if (!evictedColumns.empty()) {
+        saveColumns(evictedColumns);
+    }
+    std::erase_if(chunkManager.editedColumns, [this](const glm::ivec2 &column) {
+        return !isResident(column);
+    });
+    for (const glm::ivec3 &chunkCoords: distantChunks) {
+        chunkManager.deleteChunk(chunkCoords);
+    }
+}
+
+// the old requests are replaced, so columns the camera moved away from before they were generated are skipped
+void ChunkStreamer::requestNearbyColumns() {
+    for (int z = -columnRadius; z <= columnRadius; z++) {
+        for (int x = -columnRadius; x <= columnRadius; x++) {
+            const glm::ivec2 column = cameraColumn + glm::ivec2(x, z);
+            if (isInRadius(column, columnRadius)) {
+                columns.try_emplace(column, ColumnState::Pending);
+            }
+        }
+    }
+
+    std::vector<glm::ivec2> newRequests;
+    for (const auto &[column, state]: columns) {
+        if (state == ColumnState::Pending) {
+            newRequests.push_back(column);
+        }
+    }
+
+    auto distanceSquared = [this](const glm::ivec2 &column) {
+        const glm::ivec2 offset = column - cameraColumn;
+        return offset.x * offset.x + offset.y * offset.y;
+    };
+    std::ranges::sort(newRequests, [&](const glm::ivec2 &a, const glm::ivec2 &b) {
+        return distanceSquared(a) > distanceSquared(b);
+    });
+
+    {
+        std::lock_guard lock(queueMutex);
+        requests = std::move(newRequests);
+    }
+    requestReady.notify_one();
+}
+
+bool ChunkStreamer::isResident(const glm::ivec2 &column) const {
+    const auto it = columns.find(column);
+    return it != columns.end() && it->second == ColumnState::Resident;
+}
+
+bool ChunkStreamer::isInRadius(const glm::ivec2 &column, const int radius) const {
+    const glm::ivec2 offset = column - cameraColumn;
+    return offset.x * offset.x + offset.y * offset.y <= radius * radius;
+}
@@ -0,0 +1,87 @@
+#ifndef CHUNKSTREAMER_H
+#define CHUNKSTREAMER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "ChunkManager.h"
+
+// a column of chunks generated on the streaming thread, waiting to be inserted on the main thread
+struct StreamedColumn {
+    glm::ivec2 column;
+    std::vector<Block> blocks;
+};
+
+// keeps the chunk columns within a radius of the camera resident
+// columns are generated on a background thread, nearest first, and inserted into the chunk manager by update, so
+// the chunk map is only ever touched on the main thread. columns are evicted a column further out than they are
+// loaded, so moving back and forth over a column border doesn't reload anything
+// only resident columns can be edited, see ChunkManager::isColumnEditable, so streamed terrain never lands on edits
+class ChunkStreamer {
+public:
+    // the generator is called on the streaming thread and must only read shared state
+    using ColumnGenerator = std::function<std::vector<Block>(const glm::ivec2 &column)>;
+    // called on the main thread with the columns about to be evicted, while their chunks still exist
+    using ColumnSaver = std::function<void(std::span<const glm::ivec2> columns)>;
+
+    ChunkStreamer(ChunkManager &chunkManager, ColumnGenerator generateColumn, ColumnSaver saveColumns,
+                  int viewDistance);
+
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer &) = delete;
+
+    ChunkStreamer &operator=(const ChunkStreamer &) = delete;
+
+    // queues and evicts columns when the camera enters a new one, then inserts finished columns up to a fixed budget
+    void update(const glm::vec3 &cameraPosition);
+
+    [[nodiscard]] uint32_t residentColumnCount() const;
+
+    [[nodiscard]] uint32_t pendingColumnCount() const;
+
+private:
+    static constexpr int MAX_COLUMNS_PER_UPDATE = 64;
+
+    enum class ColumnState : uint8_t {
+        Pending,
+        Resident
+    };
+
+    ChunkManager &chunkManager;
+    ColumnGenerator generateColumn;
+    ColumnSaver saveColumns;
+    int columnRadius;
+    glm::ivec2 cameraColumn{};
+    bool started = false;
+    std::unordered_map<glm::ivec2, ColumnState> columns;
+
+    // shared with the streaming thread, requests are sorted so the nearest column is at the back
+    mutable std::mutex queueMutex;
+    std::condition_variable_any requestReady;
+    std::vector<glm::ivec2> requests;
+    std::vector<StreamedColumn> finishedColumns;
+
+    // declared last so the thread is stopped before anything it uses is destroyed
+    std::jthread streamingThread;
+
+    void streamColumns(const std::stop_token &stopToken);
+
+    void evictDistantColumns();
+
+    void requestNearbyColumns();
+
+    [[nodiscard]] bool isInRadius(const glm::ivec2 &column, int radius) const;
+
+    [[nodiscard]] bool isResident(const glm::ivec2 &column) const;
+};
+
+#endif //CHUNKSTREAMER_H
@@ -0,0 +1,55 @@
+#include "MaterialRegistry.h"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// every possible id is reserved up front, so registering a material never moves the ones other threads are reading
+static std::vector<Material> createMaterialTable() {
+    std::vector<Material> materials;
+    materials.reserve(std::numeric_limits<MaterialID>::max() + 1);
+    materials.push_back({0, 0, 0, 0});
+    return materials;
+}
+
+std::vector<Material> MaterialRegistry::materials = createMaterialTable();
+std::unordered_map<uint32_t, MaterialID> MaterialRegistry::materialIDs;
+std::mutex MaterialRegistry::registryMutex;
+
+// blocks are always opaque, so the alpha channel is ignored like it is in Block::setColor
+MaterialID MaterialRegistry::getMaterialID(const uint8_t color[4]) {
+    const uint8_t opaqueColor[4] = {color[0], color[1], color[2], 255};
+    uint32_t colorKey;
+    std::memcpy(&colorKey, opaqueColor, sizeof(colorKey));
+
+    std::lock_guard lock(registryMutex);
+    if (const auto it = materialIDs.find(colorKey); it != materialIDs.end()) {
+        return it->second;
+    }
+
+    if (materials.size() > std::numeric_limits<MaterialID>::max()) {
+        throw std::runtime_error("material registry error: too many materials!");
+    }
+
+    const auto materialID = static_cast<MaterialID>(materials.size());
+    Material material{};
+    std::memcpy(material.color, opaqueColor, sizeof(material.color));
+    materials.push_back(material);
+    materialIDs[colorKey] = materialID;
+    return materialID;
+}
+
+const Material &MaterialRegistry::getMaterial(const MaterialID materialID) {
+    return materials[materialID];
+}
+
+Block MaterialRegistry::getBlock(const MaterialID materialID, const glm::vec3 &position) {
+    Block block{position, {}};
+    std::memcpy(block.color, materials[materialID].color, sizeof(block.color));
+    return block;
+}
+
+uint32_t MaterialRegistry::materialCount() {
+    std::lock_guard lock(registryMutex);
+    return materials.size();
+}
@@ -0,0 +1,38 @@
+#ifndef MATERIALREGISTRY_H
+#define MATERIALREGISTRY_H
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Block.h"
+
+using MaterialID = uint16_t;
+
+constexpr MaterialID AIR_MATERIAL = 0;
+
+struct Material {
+    uint8_t color[4];
+};
+
+// global table of block types, chunks only store small material ids (or palette indices into them)
+// id 0 is reserved for air, every other id is created the first time its color is registered
+// registering is thread safe, and looking up an id that has already been handed out never blocks
+class MaterialRegistry {
+public:
+    static MaterialID getMaterialID(const uint8_t color[4]);
+
+    static const Material &getMaterial(MaterialID materialID);
+
+    static Block getBlock(MaterialID materialID, const glm::vec3 &position);
+
+    static uint32_t materialCount();
+
+private:
+    static std::vector<Material> materials;
+    static std::unordered_map<uint32_t, MaterialID> materialIDs;
+    static std::mutex registryMutex;
+};
+
+#endif //MATERIALREGISTRY_H
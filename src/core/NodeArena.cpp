@@ -0,0 +1,74 @@
+#include "NodeArena.h"
+
+#include <algorithm>
+
+std::atomic<uint64_t> NodeArena::pageAllocations = 0;
+
+NodeArena::~NodeArena() {
+    release();
+}
+
+void NodeArena::release() {
+    for (const auto page: pages) {
+        ::operator delete(page);
+    }
+    pages.clear();
+    cursor = nullptr;
+    remainingBytes = 0;
+    reservedBytes = 0;
+    nodeCount = 0;
+    freeLists.clear();
+}
+
+uint32_t NodeArena::getNodeCount() const {
+    return nodeCount;
+}
+
+size_t NodeArena::getReservedBytes() const {
+    return reservedBytes;
+}
+
+uint64_t NodeArena::getPageAllocationCount() {
+    return pageAllocations.load(std::memory_order_relaxed);
+}
+
+// pages grow geometrically so sparse chunks stay small, while dense chunks only need a handful of pages
+void *NodeArena::allocate(const size_t size, const size_t alignment) {
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(cursor) % alignment) % alignment;
+
+    if (cursor == nullptr || padding + size > remainingBytes) {
+        const size_t pageSize = std::max(size, std::clamp(reservedBytes, MIN_PAGE_SIZE, MAX_PAGE_SIZE));
+        cursor = static_cast<std::byte *>(::operator new(pageSize));
+        pages.push_back(cursor);
+        remainingBytes = pageSize;
+        reservedBytes += pageSize;
+        padding = 0;
+        pageAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void *memory = cursor + padding;
+    cursor += padding + size;
+    remainingBytes -= padding + size;
+    return memory;
+}
+
+void *NodeArena::takeFreeBlock(const size_t size) {
+    for (FreeList &freeList: freeLists) {
+        if (freeList.size == size && !freeList.blocks.empty()) {
+            void *block = freeList.blocks.back();
+            freeList.blocks.pop_back();
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+void NodeArena::addFreeBlock(void *block, const size_t size) {
+    for (FreeList &freeList: freeLists) {
+        if (freeList.size == size) {
+            freeList.blocks.push_back(block);
+            return;
+        }
+    }
+    freeLists.push_back({size, {block}});
+}
@@ -0,0 +1,75 @@
+#ifndef NODEARENA_H
+#define NODEARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+// bump allocator for a chunk's octree nodes
+// a node handed back with destroy is reused by the next node of the same size, pages are only freed when the whole
+// arena is released with its chunk, so anything allocated here must not own memory outside the arena
+class NodeArena {
+public:
+    NodeArena() = default;
+
+    ~NodeArena();
+
+    NodeArena(const NodeArena &) = delete;
+
+    NodeArena &operator=(const NodeArena &) = delete;
+
+    template<typename T, typename... Args>
+    T *create(Args &&... args) {
+        void *memory = freeLists.empty() ? nullptr : takeFreeBlock(sizeof(T));
+        if (memory == nullptr) {
+            memory = allocate(sizeof(T), alignof(T));
+        }
+        nodeCount++;
+        return new(memory) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    void destroy(T *node) {
+        node->~T();
+        addFreeBlock(node, sizeof(T));
+        nodeCount--;
+    }
+
+    void release();
+
+    [[nodiscard]] uint32_t getNodeCount() const;
+
+    [[nodiscard]] size_t getReservedBytes() const;
+
+    static uint64_t getPageAllocationCount();
+
+private:
+    static constexpr size_t MIN_PAGE_SIZE = 1024;
+    static constexpr size_t MAX_PAGE_SIZE = 16384;
+
+    static std::atomic<uint64_t> pageAllocations;
+
+    // there are only a couple of node sizes, so the lists are found by a linear search
+    struct FreeList {
+        size_t size;
+        std::vector<void *> blocks;
+    };
+
+    std::vector<std::byte *> pages;
+    std::byte *cursor = nullptr;
+    size_t remainingBytes = 0;
+    size_t reservedBytes = 0;
+    uint32_t nodeCount = 0;
+    std::vector<FreeList> freeLists;
+
+    void *allocate(size_t size, size_t alignment);
+
+    void *takeFreeBlock(size_t size);
+
+    void addFreeBlock(void *block, size_t size);
+};
+
+#endif //NODEARENA_H
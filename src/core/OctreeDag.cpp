@@ -0,0 +1,162 @@
+#include "OctreeDag.h"
+
+#ifdef VOXEL_OCTREE_DAG
+bool OCTREE_DAG_COMPRESSION = true;
+#else
+bool OCTREE_DAG_COMPRESSION = false;
+#endif
+
+std::size_t ChildArrayHash::operator()(const std::array<OctreeNode *, 8> &children) const noexcept {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const auto child: children) {
+        hash ^= reinterpret_cast<uintptr_t>(child);
+        hash *= 0x100000001b3ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+OctreeNode *OctreeDag::intern(OctreeNode *node, const int depth) {
+    if (node->refCount > 0) {
+        node->refCount++;
+        return node;
+    }
+
+    if (depth == MAX_DEPTH) {
+        auto [it, inserted] = leaves.try_emplace(node->material, nullptr);
+        if (!inserted) {
+            it->second->refCount++;
+            return it->second;
+        }
+
+        OctreeNode *leaf;
+        if (!freeLeaves.empty()) {
+            leaf = freeLeaves.back();
+            freeLeaves.pop_back();
+        }
+        else {
+            leaf = arena.create<OctreeNode>();
+        }
+        leaf->material = node->material;
+        leaf->refCount = 1;
+        it->second = leaf;
+        return leaf;
+    }
+
+    // children are interned first so identical subtrees end up with identical child pointers
+    std::array<OctreeNode *, 8> children{};
+    const auto *internalNode = static_cast<InternalNode *>(node);
+    for (int i = 0; i < 8; i++) {
+        if (internalNode->children[i] != nullptr) {
+            children[i] = intern(internalNode->children[i], depth + 1);
+        }
+    }
+
+    auto [it, inserted] = internals.try_emplace(children, nullptr);
+    if (!inserted) {
+        for (const auto child: children) {
+            if (child != nullptr) {
+                release(child, depth + 1);
+            }
+        }
+        it->second->refCount++;
+        return it->second;
+    }
+
+    InternalNode *sharedNode;
+    if (!freeInternals.empty()) {
+        sharedNode = freeInternals.back();
+        freeInternals.pop_back();
+    }
+    else {
+        sharedNode = arena.create<InternalNode>();
+    }
+    std::copy(children.begin(), children.end(), sharedNode->children);
+    sharedNode->refCount = 1;
+    it->second = sharedNode;
+    return sharedNode;
+}
+
+void OctreeDag::release(OctreeNode *node, const int depth) {
+    if (node->refCount == 0 || --node->refCount > 0) {
+        return;
+    }
+
+    if (depth == MAX_DEPTH) {
+        leaves.erase(node->material);
+        freeLeaves.push_back(node);
+        return;
+    }
+
+    auto *internalNode = static_cast<InternalNode *>(node);
+    std::array<OctreeNode *, 8> children{};
+    std::copy(std::begin(internalNode->children), std::end(internalNode->children), children.begin());
+    internals.erase(children);
+
+    for (auto &child: internalNode->children) {
+        if (child != nullptr) {
+            release(child, depth + 1);
+            child = nullptr;
+        }
+    }
+    freeInternals.push_back(internalNode);
+}
+
+void OctreeDag::releaseTree(OctreeNode *node, const int depth) {
+    if (node->refCount > 0) {
+        release(node, depth);
+        return;
+    }
+
+    if (depth == MAX_DEPTH) {
+        return;
+    }
+
+    for (const auto child: static_cast<InternalNode *>(node)->children) {
+        if (child != nullptr) {
+            releaseTree(child, depth + 1);
+        }
+    }
+}
+
+// built bottom up from nodes on the stack, which intern copies into the DAG
+OctreeNode *OctreeDag::getSolidNode(const MaterialID material, const int depth) {
+    OctreeNode leaf;
+    leaf.material = material;
+    OctreeNode *node = intern(&leaf, MAX_DEPTH);
+
+    for (int nodeDepth = MAX_DEPTH - 1; nodeDepth >= depth; nodeDepth--) {
+        InternalNode solidNode;
+        std::fill(std::begin(solidNode.children), std::end(solidNode.children), node);
+        OctreeNode *sharedNode = intern(&solidNode, nodeDepth);
+        release(node, nodeDepth + 1);
+        node = sharedNode;
+    }
+    return node;
+}
+
+OctreeNode *OctreeDag::copyNode(NodeArena &arena, const OctreeNode *node, const int depth) {
+    if (depth == MAX_DEPTH) {
+        auto *leaf = arena.create<OctreeNode>();
+        leaf->material = node->material;
+        return leaf;
+    }
+
+    auto *copy = arena.create<InternalNode>();
+    const auto *sharedNode = static_cast<const InternalNode *>(node);
+    for (int i = 0; i < 8; i++) {
+        copy->children[i] = sharedNode->children[i];
+        if (copy->children[i] != nullptr) {
+            copy->children[i]->refCount++;
+        }
+    }
+    return copy;
+}
+
+uint32_t OctreeDag::getNodeCount() const {
+    return leaves.size() + internals.size();
+}
+
+size_t OctreeDag::getReservedBytes() const {
+    return arena.getReservedBytes();
+}
@@ -0,0 +1,51 @@
+#ifndef OCTREEDAG_H
+#define OCTREEDAG_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Chunk.h"
+#include "NodeArena.h"
+
+extern bool OCTREE_DAG_COMPRESSION;
+
+struct ChildArrayHash {
+    std::size_t operator()(const std::array<OctreeNode *, 8> &children) const noexcept;
+};
+
+// hash-consed store of octree nodes shared between chunks, turning the chunk octrees into a directed acyclic graph
+// shared nodes have a refCount of at least 1, chunk-owned nodes keep a refCount of 0 and are never touched here
+// node depths follow the chunk octree: roots are at depth 0 and leaves are at MAX_DEPTH
+class OctreeDag {
+public:
+    // returns the canonical shared node for the subtree and adds a reference to it, the subtree is left untouched
+    OctreeNode *intern(OctreeNode *node, int depth);
+
+    // drops one reference to a shared node, freeing it and releasing its children once nothing refers to it
+    void release(OctreeNode *node, int depth);
+
+    // drops every reference held by a chunk-owned tree, shared subtrees are released and chunk nodes are walked
+    void releaseTree(OctreeNode *node, int depth);
+
+    // returns the shared node for an octant at depth whose blocks all have the given material and adds a reference
+    // to it. below it every octant is the same node, so a solid octant of any size takes one node per depth
+    OctreeNode *getSolidNode(MaterialID material, int depth);
+
+    // copies a shared node into a chunk's arena so it can be modified, the copy takes its own child references
+    static OctreeNode *copyNode(NodeArena &arena, const OctreeNode *node, int depth);
+
+    [[nodiscard]] uint32_t getNodeCount() const;
+
+    [[nodiscard]] size_t getReservedBytes() const;
+
+private:
+    NodeArena arena;
+    std::unordered_map<MaterialID, OctreeNode *> leaves;
+    std::unordered_map<std::array<OctreeNode *, 8>, InternalNode *, ChildArrayHash> internals;
+    std::vector<OctreeNode *> freeLeaves;
+    std::vector<InternalNode *> freeInternals;
+};
+
+#endif //OCTREEDAG_H
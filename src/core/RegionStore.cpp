@@ -0,0 +1,267 @@
+#include "RegionStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "../util/ByteUtil.h"
+#include "../util/ThreadPool.h"
+
+static_assert(CHUNK_BLOCK_COUNT <= std::numeric_limits<uint16_t>::max(), "a run must be able to cover a chunk");
+
+RegionStore::RegionStore(std::filesystem::path directory) : directory(std::move(directory)) {
+}
+
+// chunks are gathered with one pass over the chunk map, then the columns are encoded on the thread pool
+void RegionStore::saveColumns(const ChunkManager &chunkManager, const std::span<const glm::ivec2> columns) {
+    std::unordered_map<glm::ivec2, std::vector<const Chunk *>> columnChunks;
+    for (const glm::ivec2 &column: columns) {
+        columnChunks.try_emplace(column);
+    }
+    for (const auto &[chunkCoords, chunk]: chunkManager.chunks) {
+        if (const auto it = columnChunks.find({chunkCoords.x, chunkCoords.z}); it != columnChunks.end()) {
+            it->second.push_back(&chunk);
+        }
+    }
+
+    std::vector<std::pair<glm::ivec2, std::vector<const Chunk *>>> pendingColumns(columnChunks.begin(),
+                                                                                   columnChunks.end());
+    std::vector<std::vector<std::byte>> encodedColumns(pendingColumns.size());
+    ThreadPool::parallelFor(pendingColumns.size(), [&](const size_t i) {
+        std::ranges::sort(pendingColumns[i].second, {}, [](const Chunk *chunk) { return chunk->coords.y; });
+        encodedColumns[i] = encodeColumn(pendingColumns[i].second);
+    });
+
+    std::unordered_map<glm::ivec2, std::unordered_map<glm::ivec2, std::vector<std::byte>>> regionRecords;
+    for (size_t i = 0; i < pendingColumns.size(); i++) {
+        const glm::ivec2 &column = pendingColumns[i].first;
+        regionRecords[column >> REGION_EDGE_BITS][column] = std::move(encodedColumns[i]);
+    }
+
+    std::filesystem::create_directories(directory);
+    for (const auto &[region, records]: regionRecords) {
+        saveRegion(region, records);
+    }
+}
+
+// the lock is held while the runs are expanded, so a save can't unmap the region halfway through
+bool RegionStore::loadColumn(const glm::ivec2 &column, std::vector<Block> &blocks) {
+    std::lock_guard lock(regionMutex);
+    const MappedFile *regionFile = getMappedRegion(column >> REGION_EDGE_BITS);
+    if (regionFile == nullptr) {
+        return false;
+    }
+
+    const std::span<const std::byte> record = findColumnRecord(*regionFile, getColumnIndex(column));
+    if (record.empty()) {
+        return false;
+    }
+
+    decodeColumn(record, column, blocks);
+    return true;
+}
+
+const std::filesystem::path &RegionStore::getDirectory() const {
+    return directory;
+}
+
+std::filesystem::path RegionStore::getRegionPath(const glm::ivec2 &region) const {
+    return directory / ("r." + std::to_string(region.x) + "." + std::to_string(region.y) + ".vxr");
+}
+
+// must be called with the region lock held, returns null if the region has never been saved
+const MappedFile *RegionStore::getMappedRegion(const glm::ivec2 &region) {
+    if (const auto it = mappedRegions.find(region); it != mappedRegions.end()) {
+        return &it->second;
+    }
+
+    const std::filesystem::path regionPath = getRegionPath(region);
+    if (!std::filesystem::exists(regionPath)) {
+        return nullptr;
+    }
+
+    MappedFile regionFile(regionPath);
+    const auto regionData = std::span(regionFile.data(), regionFile.size());
+    size_t offset = 0;
+    const auto header = readValue<RegionHeader>(regionData, offset);
+    if (std::memcmp(header.magic, REGION_MAGIC, sizeof(REGION_MAGIC)) != 0) {
+        throw std::runtime_error("region file error: " + regionPath.string() + " is not a region file!");
+    }
+    if (header.byteOrderMark != BYTE_ORDER_MARK) {
+        throw std::runtime_error("region file error: " + regionPath.string() + " was saved with another byte order!");
+    }
+    if (header.version != REGION_VERSION || header.columnCount != REGION_COLUMN_COUNT ||
+        regionFile.size() < RECORDS_OFFSET) {
+        throw std::runtime_error("region file error: " + regionPath.string() + " is not a region file!");
+    }
+    if (header.chunkEdge != CHUNK_EDGE) {
+        throw std::runtime_error("region file error: " + regionPath.string() + " was saved with another chunk size!");
+    }
+
+    return &mappedRegions.emplace(region, std::move(regionFile)).first->second;
+}
+
+// the region is written to a temporary file that replaces the old one, columns that aren't being saved are copied
+// over from the old file as they are
+void RegionStore::saveRegion(const glm::ivec2 &region,
+                             const std::unordered_map<glm::ivec2, std::vector<std::byte>> &records) {
+    std::lock_guard lock(regionMutex);
+    const MappedFile *oldRegionFile = getMappedRegion(region);
+
+    std::vector<std::byte> regionData;
+    RegionHeader header{};
+    std::memcpy(header.magic, REGION_MAGIC, sizeof(REGION_MAGIC));
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.version = REGION_VERSION;
+    header.chunkEdge = CHUNK_EDGE;
+    header.columnCount = REGION_COLUMN_COUNT;
+    appendValue(regionData, header);
+    regionData.resize(RECORDS_OFFSET);
+
+    for (int columnIndex = 0; columnIndex < REGION_COLUMN_COUNT; columnIndex++) {
+        const glm::ivec2 column = region * REGION_EDGE + glm::ivec2(columnIndex % REGION_EDGE,
+                                                                    columnIndex / REGION_EDGE);
+        std::span<const std::byte> record;
+        if (const auto it = records.find(column); it != records.end()) {
+            record = it->second;
+        }
+        else if (oldRegionFile != nullptr) {
+            record = findColumnRecord(*oldRegionFile, columnIndex);
+        }
+
+        if (record.empty()) {
+            continue;
+        }
+
+        const RegionTableEntry entry{static_cast<uint32_t>(regionData.size()), static_cast<uint32_t>(record.size())};
+        std::memcpy(regionData.data() + TABLE_OFFSET + columnIndex * sizeof(RegionTableEntry), &entry, sizeof(entry));
+        regionData.insert(regionData.end(), record.begin(), record.end());
+    }
+
+    // the old file is still mapped until here, and has to be unmapped before it can be replaced
+    mappedRegions.erase(region);
+
+    const std::filesystem::path regionPath = getRegionPath(region);
+    std::filesystem::path temporaryPath = regionPath;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream regionStream(temporaryPath, std::ios::binary | std::ios::trunc);
+        regionStream.write(reinterpret_cast<const char *>(regionData.data()),
+                           static_cast<std::streamsize>(regionData.size()));
+        if (!regionStream) {
+            throw std::runtime_error("region file error: failed to write " + temporaryPath.string() + "!");
+        }
+    }
+    std::filesystem::rename(temporaryPath, regionPath);
+}
+
+// blocks are run-length encoded in dense order, terrain is mostly air with flat layers of a few colors, so the runs
+// are long. chunks are stored in the order they are given
+std::vector<std::byte> RegionStore::encodeColumn(const std::span<const Chunk *const> chunks) {
+    std::vector<uint32_t> colors = {0};
+    std::unordered_map<MaterialID, uint16_t> colorIndices = {{AIR_MATERIAL, 0}};
+    std::vector<std::byte> chunkData;
+    std::vector<MaterialID> materials(CHUNK_BLOCK_COUNT);
+
+    for (const Chunk *chunk: chunks) {
+        if (chunk->storage == ChunkStorage::Dense) {
+            for (int i = 0; i < CHUNK_BLOCK_COUNT; i++) {
+                materials[i] = chunk->dense->getMaterial(i);
+            }
+        }
+        else {
+            std::ranges::fill(materials, AIR_MATERIAL);
+            Chunk::visitLeaves(chunk->octree, glm::ivec3(0), [&](const OctreeNode *blockNode,
+                                                                 const glm::ivec3 &localPos) {
+                materials[Chunk::getDenseIndex(localPos)] = blockNode->material;
+            });
+        }
+
+        std::vector<BlockRun> runs;
+        MaterialID runMaterial = AIR_MATERIAL;
+        for (int i = 0; i < CHUNK_BLOCK_COUNT; i++) {
+            if (!runs.empty() && materials[i] == runMaterial) {
+                runs.back().length++;
+                continue;
+            }
+
+            runMaterial = materials[i];
+            auto [it, inserted] = colorIndices.try_emplace(runMaterial, static_cast<uint16_t>(colors.size()));
+            if (inserted) {
+                if (colors.size() > std::numeric_limits<uint16_t>::max()) {
+                    throw std::runtime_error("region file error: too many colors in one column!");
+                }
+                uint32_t color;
+                std::memcpy(&color, MaterialRegistry::getMaterial(runMaterial).color, sizeof(color));
+                colors.push_back(color);
+            }
+            runs.push_back({it->second, 1});
+        }
+
+        appendValue(chunkData, ChunkRecord{chunk->coords.y, static_cast<uint32_t>(runs.size())});
+        for (const BlockRun &run: runs) {
+            appendValue(chunkData, run);
+        }
+    }
+
+    std::vector<std::byte> record;
+    record.reserve(sizeof(ColumnRecord) + colors.size() * sizeof(uint32_t) + chunkData.size());
+    appendValue(record, ColumnRecord{static_cast<uint32_t>(chunks.size()), static_cast<uint32_t>(colors.size())});
+    for (const uint32_t color: colors) {
+        appendValue(record, color);
+    }
+    record.insert(record.end(), chunkData.begin(), chunkData.end());
+    return record;
+}
+
+void RegionStore::decodeColumn(const std::span<const std::byte> record, const glm::ivec2 &column,
+                               std::vector<Block> &blocks) {
+    size_t offset = 0;
+    const auto columnRecord = readValue<ColumnRecord>(record, offset);
+    const size_t colorsOffset = offset;
+    offset += columnRecord.colorCount * sizeof(uint32_t);
+
+    for (uint32_t chunk = 0; chunk < columnRecord.chunkCount; chunk++) {
+        const auto chunkRecord = readValue<ChunkRecord>(record, offset);
+        const glm::ivec3 chunkCorner = Chunk::getChunkCorner({column.x, chunkRecord.chunkY, column.y});
+
+        int denseIndex = 0;
+        for (uint32_t run = 0; run < chunkRecord.runCount; run++) {
+            const auto blockRun = readValue<BlockRun>(record, offset);
+            if (blockRun.colorIndex >= columnRecord.colorCount || denseIndex + blockRun.length > CHUNK_BLOCK_COUNT) {
+                throw std::runtime_error("region file error: run is out of range!");
+            }
+
+            if (blockRun.colorIndex != 0) {
+                Block block{};
+                std::memcpy(block.color, record.data() + colorsOffset + blockRun.colorIndex * sizeof(uint32_t),
+                            sizeof(block.color));
+                for (int i = denseIndex; i < denseIndex + blockRun.length; i++) {
+                    block.position = glm::vec3(chunkCorner + Chunk::getDenseLocalPos(i));
+                    blocks.push_back(block);
+                }
+            }
+            denseIndex += blockRun.length;
+        }
+    }
+}
+
+std::span<const std::byte> RegionStore::findColumnRecord(const MappedFile &regionFile, const int columnIndex) {
+    const auto regionData = std::span(regionFile.data(), regionFile.size());
+    size_t offset = TABLE_OFFSET + columnIndex * sizeof(RegionTableEntry);
+    const auto entry = readValue<RegionTableEntry>(regionData, offset);
+    if (entry.offset == 0) {
+        return {};
+    }
+    if (static_cast<size_t>(entry.offset) + entry.size > regionData.size()) {
+        throw std::runtime_error("region file error: column record is out of range!");
+    }
+    return regionData.subspan(entry.offset, entry.size);
+}
+
+int RegionStore::getColumnIndex(const glm::ivec2 &column) {
+    return (column.x & (REGION_EDGE - 1)) + (column.y & (REGION_EDGE - 1)) * REGION_EDGE;
+}
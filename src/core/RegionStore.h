@@ -0,0 +1,96 @@
+#ifndef REGIONSTORE_H
+#define REGIONSTORE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "ChunkManager.h"
+#include "../util/MappedFile.h"
+
+// columns of chunks saved to disk in region files, each holding 32x32 chunk columns
+// a region file is a header, then an offset table with one entry per column, then the columns' records:
+//     ColumnRecord, the column's colors (index 0 is air), then for every chunk a ChunkRecord and its runs
+// the runs cover the chunk's blocks in dense order, so a column is loaded by mapping the file, one table lookup
+// and expanding the runs. every field is a 4-byte value or a pair of 2-byte ones in the byte order of the machine
+// that saved the file, the header's byte order mark keeps a file from being read on one with the other order
+class RegionStore {
+public:
+    static constexpr int REGION_EDGE_BITS = 5;
+    static constexpr int REGION_EDGE = 1 << REGION_EDGE_BITS;
+    static constexpr int REGION_COLUMN_COUNT = REGION_EDGE * REGION_EDGE;
+
+    explicit RegionStore(std::filesystem::path directory);
+
+    // writes the columns' chunks, replacing whatever was saved for them. a column without chunks is saved as empty,
+    // so it loads as empty rather than being generated again
+    void saveColumns(const ChunkManager &chunkManager, std::span<const glm::ivec2> columns);
+
+    // appends the saved blocks of the column, returns false if the column was never saved
+    // can be called from any thread, also while columns are saved
+    bool loadColumn(const glm::ivec2 &column, std::vector<Block> &blocks);
+
+    [[nodiscard]] const std::filesystem::path &getDirectory() const;
+
+private:
+    struct RegionHeader {
+        char magic[4];
+        uint32_t byteOrderMark;
+        uint32_t version;
+        uint32_t chunkEdge;
+        uint32_t columnCount;
+    };
+
+    struct RegionTableEntry {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct ColumnRecord {
+        uint32_t chunkCount;
+        uint32_t colorCount;
+    };
+
+    struct ChunkRecord {
+        int32_t chunkY;
+        uint32_t runCount;
+    };
+
+    struct BlockRun {
+        uint16_t colorIndex;
+        uint16_t length;
+    };
+
+    static constexpr char REGION_MAGIC[4] = {'V', 'X', 'R', 'G'};
+    static constexpr uint32_t REGION_VERSION = 2;
+    // reads back as 0x04030201 where the bytes are in the other order
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr size_t TABLE_OFFSET = sizeof(RegionHeader);
+    static constexpr size_t RECORDS_OFFSET = TABLE_OFFSET + sizeof(RegionTableEntry) * REGION_COLUMN_COUNT;
+
+    std::filesystem::path directory;
+    // regions that have been read are kept mapped, a region is unmapped before its file is replaced
+    std::mutex regionMutex;
+    std::unordered_map<glm::ivec2, MappedFile> mappedRegions;
+
+    std::filesystem::path getRegionPath(const glm::ivec2 &region) const;
+
+    const MappedFile *getMappedRegion(const glm::ivec2 &region);
+
+    void saveRegion(const glm::ivec2 &region, const std::unordered_map<glm::ivec2, std::vector<std::byte>> &records);
+
+    static std::vector<std::byte> encodeColumn(std::span<const Chunk *const> chunks);
+
+    static void decodeColumn(std::span<const std::byte> record, const glm::ivec2 &column, std::vector<Block> &blocks);
+
+    static std::span<const std::byte> findColumnRecord(const MappedFile &regionFile, int columnIndex);
+
+    static int getColumnIndex(const glm::ivec2 &column);
+};
+
+#endif //REGIONSTORE_H
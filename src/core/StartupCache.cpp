@@ -0,0 +1,272 @@
+#include "StartupCache.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "../util/ByteUtil.h"
+#include "../util/MappedFile.h"
+#include "../util/ThreadPool.h"
+
+static_assert(CHUNK_BLOCK_COUNT <= std::numeric_limits<uint16_t>::max(), "a run must be able to cover a chunk");
+
+StartupCache::StartupCache(std::filesystem::path path) : path(std::move(path)) {
+}
+
+// the whole file is checked first, so a broken cache is turned down before the chunk manager is touched
+// the chunks are then created on this thread and filled from the mapped file on the thread pool. the vertices and
+// indices are copied as they are, so the meshes only have to be handed to the vertex pool
+bool StartupCache::load(ChunkManager &chunkManager, const StartupCacheKey &key) const {
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+
+    const MappedFile cacheFile(path);
+    const auto cacheData = std::span(cacheFile.data(), cacheFile.size());
+    if (cacheData.size() < sizeof(CacheHeader)) {
+        return false;
+    }
+
+    size_t offset = 0;
+    const auto header = readValue<CacheHeader>(cacheData, offset);
+    if (!matchesHeader(header, createHeader(key, header.chunkCount, header.colorCount))) {
+        return false;
+    }
+
+    // a broken count must not be trusted with an allocation
+    const uint64_t tableSize = static_cast<uint64_t>(header.colorCount) * sizeof(std::array<uint8_t, 4>) +
+                               static_cast<uint64_t>(header.chunkCount) * sizeof(ChunkEntry);
+    if (tableSize > cacheData.size() - offset) {
+        return false;
+    }
+
+    std::vector<std::array<uint8_t, 4>> colors(header.colorCount);
+    std::vector<ChunkEntry> entries(header.chunkCount);
+    try {
+        for (std::array<uint8_t, 4> &color: colors) {
+            color = readValue<std::array<uint8_t, 4>>(cacheData, offset);
+        }
+
+        std::unordered_set<glm::ivec3> entryCoords;
+        for (ChunkEntry &entry: entries) {
+            entry = readValue<ChunkEntry>(cacheData, offset);
+            if (static_cast<size_t>(entry.offset) + getChunkDataSize(entry) > cacheData.size()) {
+                throw std::runtime_error("startup cache error: chunk data is out of range!");
+            }
+
+            const glm::ivec3 chunkCoords(entry.x, entry.y, entry.z);
+            if (!entryCoords.insert(chunkCoords).second) {
+                throw std::runtime_error("startup cache error: chunk is saved twice!");
+            }
+            if (chunkManager.chunks.contains(chunkCoords)) {
+                throw std::runtime_error("startup cache error: chunk already exists!");
+            }
+        }
+
+        ThreadPool::parallelFor(entries.size(), [&](const size_t i) {
+            validateChunk(cacheData.subspan(entries[i].offset, getChunkDataSize(entries[i])), entries[i],
+                          header.colorCount);
+        });
+    }
+    catch (const std::runtime_error &e) {
+        std::cout << e.what() << "\n";
+        return false;
+    }
+
+    // the colors are registered again, as this run may have handed out other material ids for them
+    std::vector<MaterialID> colorMaterials(header.colorCount, AIR_MATERIAL);
+    for (uint32_t i = 0; i < header.colorCount; i++) {
+        if (i != AIR_MATERIAL) {
+            colorMaterials[i] = MaterialRegistry::getMaterialID(colors[i].data());
+        }
+    }
+
+    std::vector<Chunk *> chunks(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        chunks[i] = &chunkManager.createChunk({entries[i].x, entries[i].y, entries[i].z});
+    }
+
+    ThreadPool::parallelFor(chunks.size(), [&](const size_t i) {
+        decodeChunk(chunkManager, *chunks[i], cacheData.subspan(entries[i].offset, getChunkDataSize(entries[i])),
+                    entries[i], colorMaterials);
+    });
+
+    for (const Chunk *chunk: chunks) {
+        ChunkManager::uploadMesh(*chunk);
+    }
+    return true;
+}
+
+// the blocks are encoded on the thread pool, the rest is copied straight out of the chunks
+// like region files, the cache is written to a temporary file that replaces the old one
+void StartupCache::save(const ChunkManager &chunkManager, const StartupCacheKey &key) const {
+    std::vector<const Chunk *> chunks;
+    chunks.reserve(chunkManager.chunks.size());
+    for (const auto &[chunkCoords, chunk]: chunkManager.chunks) {
+        chunks.push_back(&chunk);
+    }
+
+    std::vector<std::vector<BlockRun>> chunkRuns(chunks.size());
+    ThreadPool::parallelFor(chunks.size(), [&](const size_t i) {
+        chunkRuns[i] = encodeBlocks(*chunks[i]);
+    });
+
+    const uint32_t colorCount = MaterialRegistry::materialCount();
+    std::vector<ChunkEntry> entries(chunks.size());
+    size_t dataOffset = sizeof(CacheHeader) + colorCount * sizeof(uint32_t) + entries.size() * sizeof(ChunkEntry);
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const Chunk &chunk = *chunks[i];
+        entries[i] = {
+            chunk.coords.x, chunk.coords.y, chunk.coords.z, static_cast<uint32_t>(dataOffset),
+            static_cast<uint32_t>(chunkRuns[i].size()), static_cast<uint32_t>(chunk.vertices.size()),
+            static_cast<uint32_t>(chunk.indices.size())
+        };
+        dataOffset += getChunkDataSize(entries[i]);
+    }
+    if (dataOffset > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("startup cache error: the terrain is too large to cache!");
+    }
+
+    std::vector<std::byte> cacheData;
+    cacheData.reserve(dataOffset);
+    appendValue(cacheData, createHeader(key, static_cast<uint32_t>(chunks.size()), colorCount));
+    for (uint32_t material = 0; material < colorCount; material++) {
+        appendValue(cacheData, MaterialRegistry::getMaterial(static_cast<MaterialID>(material)).color);
+    }
+    for (const ChunkEntry &entry: entries) {
+        appendValue(cacheData, entry);
+    }
+    for (size_t i = 0; i < chunks.size(); i++) {
+        appendValue(cacheData, chunks[i]->sliceQuadCounts);
+        appendValues<BlockRun>(cacheData, chunkRuns[i]);
+        appendValues<ChunkVertex>(cacheData, chunks[i]->vertices);
+        appendValues<uint32_t>(cacheData, chunks[i]->indices);
+    }
+
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::filesystem::path temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream cacheStream(temporaryPath, std::ios::binary | std::ios::trunc);
+        cacheStream.write(reinterpret_cast<const char *>(cacheData.data()),
+                          static_cast<std::streamsize>(cacheData.size()));
+        if (!cacheStream) {
+            throw std::runtime_error("startup cache error: failed to write " + temporaryPath.string() + "!");
+        }
+    }
+    std::filesystem::rename(temporaryPath, path);
+}
+
+const std::filesystem::path &StartupCache::getPath() const {
+    return path;
+}
+
+StartupCache::CacheHeader StartupCache::createHeader(const StartupCacheKey &key, const uint32_t chunkCount,
+                                                     const uint32_t colorCount) {
+    CacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.meshFormatVersion = MESH_FORMAT_VERSION;
+    header.chunkEdge = CHUNK_EDGE;
+    header.vertexSize = sizeof(ChunkVertex);
+    header.meshingMode = static_cast<uint32_t>(MESHING_MODE);
+    header.key = key;
+    header.chunkCount = chunkCount;
+    header.colorCount = colorCount;
+    return header;
+}
+
+bool StartupCache::matchesHeader(const CacheHeader &header, const CacheHeader &expected) {
+    return std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 &&
+           header.version == expected.version && header.meshFormatVersion == expected.meshFormatVersion &&
+           header.chunkEdge == expected.chunkEdge && header.vertexSize == expected.vertexSize &&
+           header.meshingMode == expected.meshingMode && header.key == expected.key;
+}
+
+size_t StartupCache::getChunkDataSize(const ChunkEntry &entry) {
+    return sizeof(SliceQuadCounts) + entry.runCount * sizeof(BlockRun) + entry.vertexCount * sizeof(ChunkVertex) +
+           entry.indexCount * sizeof(uint32_t);
+}
+
+// runs follow morton order, which is the order the octree is filled in, so restoring walks each path only once
+std::vector<StartupCache::BlockRun> StartupCache::encodeBlocks(const Chunk &chunk) {
+    std::vector<MaterialID> materials(CHUNK_BLOCK_COUNT, AIR_MATERIAL);
+    if (chunk.storage == ChunkStorage::Dense) {
+        for (int i = 0; i < CHUNK_BLOCK_COUNT; i++) {
+            materials[Chunk::getMortonIndex(Chunk::getDenseLocalPos(i))] = chunk.dense->getMaterial(i);
+        }
+    }
+    else {
+        Chunk::visitLeaves(chunk.octree, glm::ivec3(0), [&](const OctreeNode *blockNode, const glm::ivec3 &localPos) {
+            materials[Chunk::getMortonIndex(localPos)] = blockNode->material;
+        });
+    }
+
+    std::vector<BlockRun> runs;
+    for (int i = 0; i < CHUNK_BLOCK_COUNT; i++) {
+        if (!runs.empty() && materials[i] == materials[i - 1]) {
+            runs.back().length++;
+            continue;
+        }
+        runs.push_back({materials[i], 1});
+    }
+    return runs;
+}
+
+// the slice quad counts have to add up to the vertices, remeshing part of the chunk later relies on them
+// the runs must fit the chunk and only use saved colors
+void StartupCache::validateChunk(const std::span<const std::byte> chunkData, const ChunkEntry &entry,
+                                 const uint32_t colorCount) {
+    size_t offset = 0;
+    const auto sliceQuadCounts = readValue<SliceQuadCounts>(chunkData, offset);
+
+    uint32_t quadCount = 0;
+    for (const uint16_t sliceQuadCount: sliceQuadCounts) {
+        quadCount += sliceQuadCount;
+    }
+    if (static_cast<uint64_t>(quadCount) * 4 != entry.vertexCount ||
+        static_cast<uint64_t>(quadCount) * 6 != entry.indexCount) {
+        throw std::runtime_error("startup cache error: mesh doesn't match its slices!");
+    }
+
+    uint32_t mortonIndex = 0;
+    for (uint32_t run = 0; run < entry.runCount; run++) {
+        const auto blockRun = readValue<BlockRun>(chunkData, offset);
+        if (blockRun.colorIndex >= colorCount || mortonIndex + blockRun.length > CHUNK_BLOCK_COUNT) {
+            throw std::runtime_error("startup cache error: run is out of range!");
+        }
+        mortonIndex += blockRun.length;
+    }
+}
+
+// the data has already been through validateChunk
+void StartupCache::decodeChunk(ChunkManager &chunkManager, Chunk &chunk, const std::span<const std::byte> chunkData,
+                               const ChunkEntry &entry, const std::span<const MaterialID> colorMaterials) {
+    size_t offset = 0;
+    chunk.sliceQuadCounts = readValue<SliceQuadCounts>(chunkData, offset);
+
+    std::vector<PendingBlock> blocks;
+    uint32_t mortonIndex = 0;
+    for (uint32_t run = 0; run < entry.runCount; run++) {
+        const auto blockRun = readValue<BlockRun>(chunkData, offset);
+        if (blockRun.colorIndex != AIR_MATERIAL) {
+            for (uint32_t i = mortonIndex; i < mortonIndex + blockRun.length; i++) {
+                blocks.push_back({chunk.coords, i, colorMaterials[blockRun.colorIndex]});
+            }
+        }
+        mortonIndex += blockRun.length;
+    }
+    chunkManager.restoreChunk(chunk, blocks);
+
+    chunk.vertices.resize(entry.vertexCount);
+    std::memcpy(chunk.vertices.data(), chunkData.data() + offset, entry.vertexCount * sizeof(ChunkVertex));
+    offset += entry.vertexCount * sizeof(ChunkVertex);
+    chunk.indices.resize(entry.indexCount);
+    std::memcpy(chunk.indices.data(), chunkData.data() + offset, entry.indexCount * sizeof(uint32_t));
+}
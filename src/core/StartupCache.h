@@ -0,0 +1,91 @@
+#ifndef STARTUPCACHE_H
+#define STARTUPCACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "ChunkManager.h"
+
+// everything the generated startup terrain depends on, a cache saved with a different key is generated again
+struct StartupCacheKey {
+    uint32_t generatorVersion;
+    uint32_t seed;
+    int32_t noiseSeed;
+    float noiseFrequency;
+    int32_t range;
+    int32_t heightScale;
+    uint32_t solidTerrain;
+    int32_t terrainFloor;
+
+    bool operator==(const StartupCacheKey &) const = default;
+};
+
+// the generated startup terrain saved together with its finished meshes, so the next launch skips generating and
+// meshing it. the file is a header, the color of every material id, a table with one entry per chunk, then each
+// chunk's data: its slice quad counts, its blocks as runs in morton order, its vertices and its indices
+// a cache is only used if it was saved with the same key, chunk size, meshing mode and mesh format
+class StartupCache {
+public:
+    explicit StartupCache(std::filesystem::path path);
+
+    // restores every saved chunk into the chunk manager and uploads their meshes to the vertex pool. returns false
+    // without touching the chunk manager if the cache can't be used: it is missing, was saved for other terrain, is
+    // broken, or holds a chunk the manager already has
+    bool load(ChunkManager &chunkManager, const StartupCacheKey &key) const;
+
+    // saves every chunk with its current mesh, so the chunks must not be waiting to be meshed
+    void save(const ChunkManager &chunkManager, const StartupCacheKey &key) const;
+
+    [[nodiscard]] const std::filesystem::path &getPath() const;
+
+private:
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t meshFormatVersion;
+        uint32_t chunkEdge;
+        uint32_t vertexSize;
+        uint32_t meshingMode;
+        StartupCacheKey key;
+        uint32_t chunkCount;
+        uint32_t colorCount;
+    };
+
+    struct ChunkEntry {
+        int32_t x;
+        int32_t y;
+        int32_t z;
+        uint32_t offset;
+        uint32_t runCount;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+    };
+
+    // colorIndex is the material id the block had when it was saved, 0 is air
+    struct BlockRun {
+        uint16_t colorIndex;
+        uint16_t length;
+    };
+
+    static constexpr char CACHE_MAGIC[4] = {'V', 'X', 'S', 'C'};
+    static constexpr uint32_t CACHE_VERSION = 2;
+
+    std::filesystem::path path;
+
+    static CacheHeader createHeader(const StartupCacheKey &key, uint32_t chunkCount, uint32_t colorCount);
+
+    static bool matchesHeader(const CacheHeader &header, const CacheHeader &expected);
+
+    static size_t getChunkDataSize(const ChunkEntry &entry);
+
+    static std::vector<BlockRun> encodeBlocks(const Chunk &chunk);
+
+    static void validateChunk(std::span<const std::byte> chunkData, const ChunkEntry &entry, uint32_t colorCount);
+
+    static void decodeChunk(ChunkManager &chunkManager, Chunk &chunk, std::span<const std::byte> chunkData,
+                            const ChunkEntry &entry, std::span<const MaterialID> colorMaterials);
+};
+
+#endif //STARTUPCACHE_H
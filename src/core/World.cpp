@@ -1,60 +1,320 @@
 #include "World.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <string>
 
+#include "../util/ThreadPool.h"
 #include "../util/TimeManager.h"
 #include "../util/TextUtil.h"
 
-World::World() : seed(2) {
+// terrain columns are filled from VOXEL_TERRAIN_FLOOR up to the surface rather than holding only their surface block
+#ifndef VOXEL_TERRAIN_FLOOR
+#define VOXEL_TERRAIN_FLOOR -32
+#endif
+
+#ifdef VOXEL_SOLID_TERRAIN
+static constexpr bool SOLID_TERRAIN = true;
+#else
+static constexpr bool SOLID_TERRAIN = false;
+#endif
+
+static constexpr int TERRAIN_FLOOR = VOXEL_TERRAIN_FLOOR;
+
+// FastNoiseLite's own defaults, set explicitly so the batched sampler can be given the same ones
+static constexpr int NOISE_SEED = 1337;
+static constexpr float NOISE_FREQUENCY = 0.01f;
+
+// the startup map is a square this many blocks wide, and noise values are scaled to heights up to this
+static constexpr int STARTUP_RANGE = 1000;
+static constexpr int TERRAIN_HEIGHT_SCALE = 15;
+
+// bump whenever the generator places different blocks for the same parameters, so old startup caches are dropped
+static constexpr uint32_t TERRAIN_GENERATOR_VERSION = 1;
+
+// region files are read from and written to this directory, relative to where the game is started
+static const std::filesystem::path SAVE_DIRECTORY = "saves";
+
+World::World() : noiseBatch(NOISE_SEED, NOISE_FREQUENCY), batchedNoise(false), seed(2), regionStore(SAVE_DIRECTORY),
+                 startupCache(SAVE_DIRECTORY / "startup.vxc") {
 }
 
 static Block greenBlock = {glm::vec3(0.0f, 0.0f, 0.0f), 0, 150, 0};
 
+// terrain gets lighter with height, two blocks at a time, and is black from y = -11 down
+static void setTerrainColor(Block& block, const int y) {
+    const int redBlueColor = std::clamp((y * 4) / 8 * 8, 0, 255);
+    const int greenColor = std::clamp((y * 4 + 50) / 8 * 8, 0, 255);
+    Block::setColor(block, redBlueColor, greenColor, redBlueColor);
+}
+
+// solid columns are only inserted block by block down to the tile's lowest surface, everything below is the same
+// slab of layers for the whole tile and is filled with boxes instead
+static int getColumnsFloor(const TerrainTile& tile) {
+    if (!SOLID_TERRAIN) {
+        return std::numeric_limits<int>::max();
+    }
+    return std::max(TERRAIN_FLOOR, *std::ranges::min_element(tile.heights));
+}
+
+static int getColumnBottom(const int height, const int columnsFloor) {
+    return SOLID_TERRAIN ? std::max(std::min(height, columnsFloor), TERRAIN_FLOOR) : height;
+}
+
+// generation runs in three passes over chunk-wide tiles: heights are sampled in parallel, the chunks they land in
+// are created on this thread, then every tile inserts its blocks into its own chunks in parallel
+// with solid terrain a fourth pass on this thread fills the slab below each tile's columns, it comes last because
+// the boxes share nodes through the DAG, whose reference counts must not be touched from several threads
+// the chunk map is only read while tiles are filled, so no locking is needed and the result doesn't depend on
+// the number of threads
 uint32_t World::generateTerrainFromNoise(const int range) {
     const int halfRange = range / 2;
-    Block terrainBlock = greenBlock;
-    uint32_t blocksGenerated = 0;
+    const int minTile = -halfRange >> CHUNK_EDGE_BITS;
+    const int tilesPerSide = ((halfRange - 1) >> CHUNK_EDGE_BITS) - minTile + 1;
 
-    for (int x = -halfRange; x < halfRange; x++) {
-        for (int z = -halfRange; z < halfRange; z++) {
-            float noiseInfo = noise.GetNoise(static_cast<float>(x), static_cast<float>(z));
-            noiseInfo = (noiseInfo + 1) / 2;
+    std::vector<TerrainTile> tiles(tilesPerSide * tilesPerSide);
+    for (size_t i = 0; i < tiles.size(); i++) {
+        const glm::ivec2 tileCorner = glm::ivec2(minTile + i % tilesPerSide, minTile + i / tilesPerSide) * CHUNK_EDGE;
+        tiles[i].minColumn = glm::max(tileCorner, glm::ivec2(-halfRange));
+        tiles[i].maxColumn = glm::min(tileCorner + CHUNK_EDGE, glm::ivec2(halfRange));
+    }
 
-            const int height = static_cast<int>(noiseInfo * 15);
+    // per-thread time spent on tiles, to show how evenly the work was spread
+    std::vector<float> threadTimes(ThreadPool::getThreadCount(), 0.0f);
+    auto timeTileJob = [&threadTimes](auto tileJob) {
+        return [&threadTimes, tileJob](const size_t i) {
+            const auto startTime = std::chrono::high_resolution_clock::now();
+            tileJob(i);
+            const std::chrono::duration<float> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+            threadTimes[ThreadPool::getThreadIndex()] += elapsed.count();
+        };
+    };
 
-            for (int y = height; y <= height; y++) {
-                int redBlueColor = (y * 4) / 8 * 8;
-                int greenColor = (y * 4 + 50) / 8 * 8;
-                redBlueColor = std::clamp(redBlueColor, 0, 255);
-                greenColor = std::clamp(greenColor, 0, 255);
+    ThreadPool::parallelFor(tiles.size(), timeTileJob([&](const size_t i) {
+        sampleTileHeights(tiles[i]);
+    }));
 
-                terrainBlock.position = {x, y, z};
-                Block::setColor(terrainBlock, redBlueColor, greenColor, redBlueColor);
+    for (const TerrainTile& tile : tiles) {
+        const int columnCount = tile.maxColumn.x - tile.minColumn.x;
+        const int columnsFloor = getColumnsFloor(tile);
+        for (size_t i = 0; i < tile.heights.size(); i++) {
+            const glm::ivec3 topChunk = Chunk::getChunkCoords(glm::vec3(
+                tile.minColumn.x + static_cast<int>(i) % columnCount,
+                tile.heights[i],
+                tile.minColumn.y + static_cast<int>(i) / columnCount));
+            const int bottomChunkY = std::min(getColumnBottom(tile.heights[i], columnsFloor), tile.heights[i]) >>
+                                     CHUNK_EDGE_BITS;
 
-                addBlock(terrainBlock);
-                blocksGenerated++;
+            for (int chunkY = bottomChunkY; chunkY <= topChunk.y; chunkY++) {
+                const glm::ivec3 chunkCoords(topChunk.x, chunkY, topChunk.z);
+                if (chunkManager.getChunk(chunkCoords) == nullptr) {
+                    chunkManager.createChunk(chunkCoords);
+                }
             }
         }
     }
 
+    std::vector<uint32_t> tileBlockCounts(tiles.size());
+    ThreadPool::parallelFor(tiles.size(), timeTileJob([&](const size_t i) {
+        tileBlockCounts[i] = fillTile(tiles[i]);
+    }));
+
+    if (SOLID_TERRAIN) {
+        TimeManager::startTimer("fillTileBases");
+        for (size_t i = 0; i < tiles.size(); i++) {
+            tileBlockCounts[i] += fillTileBase(tiles[i]);
+        }
+        TimeManager::addTimeToProfiler("fillTileBases", TimeManager::finishTimer("fillTileBases"));
+    }
+
+    for (size_t i = 0; i < threadTimes.size(); i++) {
+        TimeManager::addTimeToProfiler("generateTerrain thread " + std::to_string(i), threadTimes[i]);
+    }
+
+    uint32_t blocksGenerated = 0;
+    for (const uint32_t blockCount : tileBlockCounts) {
+        blocksGenerated += blockCount;
+    }
     return blocksGenerated;
 }
 
-void World::init() {
+// each tile samples with its own copy of the generator, so threads never share noise state
+// the batched sampler fills the whole tile in one call, GetNoise is only used if the two don't agree
+void World::sampleTileHeights(TerrainTile& tile) const {
+    const int width = tile.maxColumn.x - tile.minColumn.x;
+    const int depth = tile.maxColumn.y - tile.minColumn.y;
+    std::vector<float> samples(width * depth);
+
+    if (batchedNoise) {
+        noiseBatch.sampleGrid(tile.minColumn.x, tile.minColumn.y, width, depth, samples.data());
+    } else {
+        const FastNoiseLite tileNoise = noise;
+        for (int z = 0; z < depth; z++) {
+            for (int x = 0; x < width; x++) {
+                samples[z * width + x] = tileNoise.GetNoise(static_cast<float>(tile.minColumn.x + x),
+                                                            static_cast<float>(tile.minColumn.y + z));
+            }
+        }
+    }
+
+    tile.heights.resize(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        const float noiseInfo = (samples[i] + 1) / 2;
+        tile.heights[i] = static_cast<int>(noiseInfo * TERRAIN_HEIGHT_SCALE);
+    }
+}
+
+// the tile's chunks must already exist, addBlocks then only reads the chunk map
+uint32_t World::fillTile(const TerrainTile& tile) {
+    std::vector<Block> terrainBlocks;
+    getTileBlocks(tile, getColumnsFloor(tile), terrainBlocks);
+    chunkManager.addBlocks(terrainBlocks);
+    return terrainBlocks.size();
+}
+
+// one box per run of layers with the same color, a box covering whole chunks leaves them as a single shared node
+uint32_t World::fillTileBase(const TerrainTile& tile) {
+    if (!SOLID_TERRAIN) {
+        return 0;
+    }
+
+    const int columnsFloor = getColumnsFloor(tile);
+    Block layerBlock = greenBlock;
+    Block nextLayerBlock = greenBlock;
+    int runStart = TERRAIN_FLOOR;
+    for (int y = TERRAIN_FLOOR; y < columnsFloor; y++) {
+        setTerrainColor(layerBlock, y);
+        if (y + 1 < columnsFloor) {
+            setTerrainColor(nextLayerBlock, y + 1);
+            if (std::equal(layerBlock.color, layerBlock.color + 4, nextLayerBlock.color)) {
+                continue;
+            }
+        }
+
+        chunkManager.fillGeneratedBrush(Brush::box({tile.minColumn.x, runStart, tile.minColumn.y},
+                                                   {tile.maxColumn.x - 1, y, tile.maxColumn.y - 1}),
+                                        layerBlock.color);
+        runStart = y + 1;
+    }
+
+    const int columnCount = (tile.maxColumn.x - tile.minColumn.x) * (tile.maxColumn.y - tile.minColumn.y);
+    return std::max(columnsFloor - TERRAIN_FLOOR, 0) * columnCount;
+}
+
+// solid columns reach down to columnsFloor or the floor, whichever is higher, surface columns are a single block
+void World::getTileBlocks(const TerrainTile& tile, const int columnsFloor, std::vector<Block>& blocks) const {
+    const int columnCount = tile.maxColumn.x - tile.minColumn.x;
+    Block terrainBlock = greenBlock;
+    blocks.reserve(blocks.size() + tile.heights.size());
+
+    for (size_t i = 0; i < tile.heights.size(); i++) {
+        const int x = tile.minColumn.x + static_cast<int>(i) % columnCount;
+        const int z = tile.minColumn.y + static_cast<int>(i) / columnCount;
+        const int height = tile.heights[i];
+        for (int y = getColumnBottom(height, columnsFloor); y <= height; y++) {
+            terrainBlock.position = {x, y, z};
+            setTerrainColor(terrainBlock, y);
+            blocks.push_back(terrainBlock);
+        }
+    }
+}
+
+// runs on the streaming thread, a saved column is loaded as it was, otherwise it is generated as one terrain tile
+// its blocks are handed over one by one, so solid columns are generated whole down to the floor
+std::vector<Block> World::generateColumn(const glm::ivec2& column) {
+    std::vector<Block> blocks;
+    if (regionStore.loadColumn(column, blocks)) {
+        return blocks;
+    }
+
+    TerrainTile tile;
+    tile.minColumn = column * CHUNK_EDGE;
+    tile.maxColumn = tile.minColumn + CHUNK_EDGE;
+    sampleTileHeights(tile);
+    getTileBlocks(tile, TERRAIN_FLOOR, blocks);
+    return blocks;
+}
+
+// only edited columns are written, the rest can be generated again
+void World::saveEditedColumns(const std::span<const glm::ivec2> columns) {
+    std::vector<glm::ivec2> editedColumns;
+    for (const glm::ivec2& column : columns) {
+        if (chunkManager.editedColumns.erase(column) > 0) {
+            editedColumns.push_back(column);
+        }
+    }
+
+    if (!editedColumns.empty()) {
+        regionStore.saveColumns(chunkManager, editedColumns);
+    }
+}
+
+void World::init(const WorldSettings& worldSettings) {
+    settings = worldSettings;
     noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    noise.SetSeed(NOISE_SEED);
+    noise.SetFrequency(NOISE_FREQUENCY);
+    batchedNoise = noiseBatch.matches(noise);
+    if (!batchedNoise) {
+        std::cout << "Batched noise doesn't match FastNoiseLite in this build, sampling one column at a time\n";
+    }
     //addBlock(yellowBlock);
     //chunkManager.fillChunk(yellowBlock.position, yellowBlock);
+    chunkManager.setLodDistance(settings.lodDistance);
+
+    if (settings.viewDistance > 0) {
+        std::cout << "Streaming terrain within " << settings.viewDistance << " blocks of the camera!\n";
+        chunkStreamer = std::make_unique<ChunkStreamer>(chunkManager, [this](const glm::ivec2& column) {
+            return generateColumn(column);
+        }, [this](const std::span<const glm::ivec2> columns) {
+            saveEditedColumns(columns);
+        }, settings.viewDistance);
+        return;
+    }
+
+    if (!settings.startupCache || !loadStartupTerrain()) {
+        generateStartupTerrain();
+    }
 
-    constexpr int range = 1000;
+    TimeManager::printAllProfiling();
+}
+
+// fails if there is no startup cache or it was saved for other terrain, which is then generated and saved again
+bool World::loadStartupTerrain() {
+    TimeManager::startTimer("loadStartupCache");
+    if (!startupCache.load(chunkManager, getStartupCacheKey())) {
+        TimeManager::finishTimer("loadStartupCache");
+        std::cout << "No usable startup cache at " << startupCache.getPath().string() << "\n";
+        return false;
+    }
+    TimeManager::addTimeToProfiler("loadStartupCache", TimeManager::finishTimer("loadStartupCache"));
+
+    std::cout << "Loaded " << TextUtil::getCommaString(chunkManager.chunkCount()) << " chunks from " <<
+            startupCache.getPath().string() << "!\n";
+    compressStartupTerrain();
+    return true;
+}
+
+void World::generateStartupTerrain() {
     std::cout << "Started generating terrain! ";
 
     TimeManager::startTimer("generateTerrain");
-    const uint32_t numBlocksGenerated = generateTerrainFromNoise(range);
-    TimeManager::addTimeToProfiler("generateTerrain", TimeManager::finishTimer("generateTerrain"));
+    const uint32_t numBlocksGenerated = generateTerrainFromNoise(STARTUP_RANGE);
+    const float generationTime = TimeManager::finishTimer("generateTerrain");
+    TimeManager::addTimeToProfiler("generateTerrain", generationTime);
+    TimeManager::addCountToProfiler("octree node allocations", chunkManager.octreeNodeCount());
+    TimeManager::addCountToProfiler("node arena page allocations", NodeArena::getPageAllocationCount());
+    TimeManager::addCountToProfiler("octree bytes", chunkManager.octreeMemoryUsage());
+
+    compressStartupTerrain();
 
     std::cout << "There were " << TextUtil::getCommaString(numBlocksGenerated) << " voxels and " <<
             TextUtil::getCommaString(chunkManager.chunkCount()) << " chunks!\n";
+    std::cout << "Generated " << TextUtil::getCommaString(static_cast<uint32_t>(numBlocksGenerated / generationTime)) <<
+            " blocks/sec\n";
 
     std::cout << "Started meshing!\n";
 
@@ -62,17 +322,53 @@ void World::init() {
     chunkManager.meshAllChunks();
     TimeManager::addTimeToProfiler("meshAllChunks", TimeManager::finishTimer("meshAllChunks"));
 
-    TimeManager::printAllProfiling();
+    if (settings.startupCache) {
+        TimeManager::startTimer("saveStartupCache");
+        startupCache.save(chunkManager, getStartupCacheKey());
+        TimeManager::addTimeToProfiler("saveStartupCache", TimeManager::finishTimer("saveStartupCache"));
+    }
+}
+
+void World::compressStartupTerrain() {
+    if (!OCTREE_DAG_COMPRESSION) {
+        return;
+    }
+
+    TimeManager::startTimer("compressAllChunks");
+    chunkManager.compressAllChunks();
+    TimeManager::addTimeToProfiler("compressAllChunks", TimeManager::finishTimer("compressAllChunks"));
+    TimeManager::addCountToProfiler("octree DAG nodes", chunkManager.octreeNodeCount());
+    TimeManager::addCountToProfiler("octree DAG bytes", chunkManager.octreeMemoryUsage());
+}
+
+StartupCacheKey World::getStartupCacheKey() const {
+    return {
+        TERRAIN_GENERATOR_VERSION, seed, NOISE_SEED, NOISE_FREQUENCY, STARTUP_RANGE, TERRAIN_HEIGHT_SCALE,
+        SOLID_TERRAIN, TERRAIN_FLOOR
+    };
 }
 
 static int test = 0;
 
-void World::mainLoop() {
+void World::mainLoop(const glm::vec3& cameraPosition) {
+    if (chunkStreamer != nullptr) {
+        chunkStreamer->update(cameraPosition);
+    }
     test++;
     addBlock({glm::vec3(test, 10, 0), {255, 0, 0}});
+    chunkManager.updateLodLevels(cameraPosition);
     chunkManager.meshAllChunks();
 }
 
 void World::addBlock(const Block block) {
     chunkManager.addBlock(block);
 }
+
+void World::save() {
+    const std::vector<glm::ivec2> editedColumns(chunkManager.editedColumns.begin(), chunkManager.editedColumns.end());
+    saveEditedColumns(editedColumns);
+}
+
+ChunkManager &World::getChunkManager() {
+    return chunkManager;
+}
@@ -1,26 +1,80 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <memory>
 #include <FastNoiseLite.h>
 #include "Block.h"
 #include "ChunkManager.h"
+#include "ChunkStreamer.h"
+#include "RegionStore.h"
+#include "StartupCache.h"
+#include "../util/NoiseBatch.h"
+
+// a square of terrain columns one chunk wide, it owns every chunk above it so tiles can be filled in parallel
+struct TerrainTile {
+    glm::ivec2 minColumn;
+    glm::ivec2 maxColumn;
+    std::vector<int> heights;
+};
+
+// how the world is run, the defaults generate and mesh the whole startup map at full resolution every launch
+struct WorldSettings {
+    // radius in blocks of the terrain kept around the camera, 0 generates the whole startup map up front instead
+    int viewDistance = 0;
+    // distance in blocks from the camera where chunks start being meshed at a lower level of detail, 0 turns it off
+    float lodDistance = 0.0f;
+    // the generated startup map and its meshes are saved to a file and loaded from it on the next launch
+    bool startupCache = false;
+};
 
 class World {
 public:
     World();
 
-    void init();
+    void init(const WorldSettings &worldSettings = {});
 
-    void mainLoop();
+    void mainLoop(const glm::vec3 &cameraPosition);
 
     void addBlock(Block block);
 
+    // writes every edited column to the region files, unedited columns are generated again instead
+    void save();
+
+    ChunkManager &getChunkManager();
+
 private:
+    WorldSettings settings;
     ChunkManager chunkManager;
     FastNoiseLite noise;
+    NoiseBatch noiseBatch;
+    bool batchedNoise;
     uint32_t seed;
+    RegionStore regionStore;
+    StartupCache startupCache;
+    // only set when terrain is streamed around the camera rather than generated up front
+    std::unique_ptr<ChunkStreamer> chunkStreamer;
+
+    bool loadStartupTerrain();
+
+    void generateStartupTerrain();
+
+    void compressStartupTerrain();
+
+    [[nodiscard]] StartupCacheKey getStartupCacheKey() const;
 
     uint32_t generateTerrainFromNoise(int range);
+
+    void sampleTileHeights(TerrainTile &tile) const;
+
+    uint32_t fillTile(const TerrainTile &tile);
+
+    uint32_t fillTileBase(const TerrainTile &tile);
+
+    void getTileBlocks(const TerrainTile &tile, int columnsFloor, std::vector<Block> &blocks) const;
+
+    std::vector<Block> generateColumn(const glm::ivec2 &column);
+
+    void saveEditedColumns(std::span<const glm::ivec2> columns);
 };
 
 
@@ -0,0 +1,47 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "../core/World.h"
+#include "../util/TextUtil.h"
+#include "../util/TimeManager.h"
+
+// runs the world without a window: generates and meshes the startup map like the game does at launch, then runs
+// the given number of frames of its main loop with the camera moving along x and reports what they cost
+// usage: voxel_headless [frames]
+int main(const int argc, char *argv[]) {
+    try {
+        const int frameCount = argc > 1 ? std::stoi(argv[1]) : 0;
+
+        World world;
+        world.init();
+        ChunkManager &chunkManager = world.getChunkManager();
+
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+        for (const auto &[chunkCoords, chunk]: chunkManager.chunks) {
+            vertexCount += chunk.vertices.size();
+            indexCount += chunk.indices.size();
+        }
+        std::cout << TextUtil::getCommaString(chunkManager.chunkCount()) << " chunks, " <<
+                TextUtil::getCommaString(vertexCount) << " vertices, " << TextUtil::getCommaString(indexCount) <<
+                " indices, " << TextUtil::getCommaString(chunkManager.octreeMemoryUsage()) << " octree bytes\n";
+
+        if (frameCount > 0) {
+            TimeManager::startTimer("headlessFrames");
+            for (int frame = 0; frame < frameCount; frame++) {
+                world.mainLoop(glm::vec3(static_cast<float>(frame), 20.0f, 0.0f));
+            }
+            const float frameTime = TimeManager::finishTimer("headlessFrames");
+            std::cout << frameCount << " frames: " << frameTime * 1000 << " ms, " <<
+                    frameTime * 1000 / static_cast<float>(frameCount) << " ms per frame\n";
+        }
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -5,20 +5,35 @@
 #include "core/World.h"
 #include "rendering/MainRenderer.h"
 
+// set by CMake for the game only, see WorldSettings
+#ifndef VOXEL_VIEW_DISTANCE
+#define VOXEL_VIEW_DISTANCE 0
+#endif
+
+#ifndef VOXEL_LOD_DISTANCE
+#define VOXEL_LOD_DISTANCE 0
+#endif
+
+#ifndef VOXEL_STARTUP_CACHE
+#define VOXEL_STARTUP_CACHE 0
+#endif
+
 MainRenderer mainRenderer;
 World world;
 
 int main() {
     try {
-        world.init();
+        world.init({VOXEL_VIEW_DISTANCE, VOXEL_LOD_DISTANCE, VOXEL_STARTUP_CACHE != 0});
         mainRenderer.init();
 
         while (!glfwWindowShouldClose(MainRenderer::getWindow())) {
             glfwPollEvents();
-            world.mainLoop();
+            world.mainLoop(mainRenderer.getCameraPosition());
             mainRenderer.draw();
         }
 
+        world.save();
+
         mainRenderer.cleanup();
     }
 
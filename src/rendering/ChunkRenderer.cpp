@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <fstream>
 
+#include "vulkan/VertexLayout.h"
 #include "vulkan/VulkanBufferUtil.h"
 #include "vulkan/VulkanUtil.h"
 #include "scene/VertexPool.h"
@@ -17,8 +18,8 @@ void ChunkRenderer::init(VkDescriptorPool &descriptorPool, VkRenderPass &renderP
         pipelineLayout, graphicsPipeline, descriptorSetLayout, renderPass,
         "../src/rendering/shaders/vert.spv",
         "../src/rendering/shaders/frag.spv",
-        ChunkVertex::getBindingDescription(),
-        ChunkVertex::getAttributeDescriptions(),
+        ChunkVertexLayout::getBindingDescription(),
+        ChunkVertexLayout::getAttributeDescriptions(),
         true, true);
     vertexMemorySize = sizeof(globalChunkVertices[0]) * globalChunkVertices.size();
     indexMemorySize = sizeof(globalChunkIndices[0]) * globalChunkIndices.size();
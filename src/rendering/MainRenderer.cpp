@@ -35,3 +35,7 @@ void MainRenderer::cleanup() const {
 GLFWwindow *MainRenderer::getWindow() {
     return CoreRenderer::window;
 }
+
+glm::vec3 MainRenderer::getCameraPosition() const {
+    return camera.getPosition();
+}
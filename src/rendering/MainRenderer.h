@@ -15,6 +15,8 @@ public:
 
     static GLFWwindow *getWindow();
 
+    [[nodiscard]] glm::vec3 getCameraPosition() const;
+
 private:
     Camera camera;
     CoreRenderer coreRenderer;
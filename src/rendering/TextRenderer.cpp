@@ -4,6 +4,7 @@
 #include <iostream>
 #include <filesystem>
 
+#include "vulkan/VertexLayout.h"
 #include "vulkan/VulkanBufferUtil.h"
 #include "vulkan/VulkanUtil.h"
 #include "../util/VertexUtil.h"
@@ -23,8 +24,8 @@ void TextRenderer::init(VkDescriptorPool& descriptorPool, VkRenderPass renderPas
         pipelineLayout, textGraphicsPipeline,
         descriptorSetLayout, renderPass,
         "../src/rendering/shaders/text_vert.spv",
-        "../src/rendering/shaders/text_frag.spv", TexturedVertex::getBindingDescription(),
-        TexturedVertex::getAttributeDescriptions(), true, false);
+        "../src/rendering/shaders/text_frag.spv", TexturedVertexLayout::getBindingDescription(),
+        TexturedVertexLayout::getAttributeDescriptions(), true, false);
 }
 
 void TextRenderer::createFontAtlasGlyphs() {
@@ -79,3 +79,7 @@ void Camera::updateProj(uint32_t width, uint32_t height) const {
     float aspectRatio = static_cast<float>(width) / static_cast<float>(height);
     ubo.proj = glm::perspective(glm::radians(fovy), aspectRatio, 0.1f, 300.0f);
 }
+
+glm::vec3 Camera::getPosition() const {
+    return position;
+}
@@ -14,6 +14,8 @@ public:
 
     void updateProj(uint32_t width, uint32_t height) const;
 
+    [[nodiscard]] glm::vec3 getPosition() const;
+
 private:
     glm::vec3 position{};
     glm::vec3 front{};
@@ -1,5 +1,7 @@
 #include "VertexPool.h"
 
+#include <algorithm>
+#include <bit>
 #include <iostream>
 
 std::vector<ChunkVertex> globalChunkVertices(CHUNK_VERTICES_SIZE);
@@ -12,19 +14,35 @@ std::vector<ChunkMemoryRange> VertexPool::freeIndexRanges = {{0, CHUNK_INDICES_S
 bool VertexPool::newUpdate;
 
 void VertexPool::addToVertexPool(const std::vector<ChunkVertex> &vertices, const std::vector<uint32_t> &indices,
-                                 uint32_t chunkID) {
+                                 uint32_t chunkID, const uint32_t firstModifiedVertex,
+                                 const uint32_t firstModifiedIndex) {
     ChunkMemoryRange vertexRangeToUse = getAvailableMemoryRange(occupiedVertexRanges, freeVertexRanges, chunkID,
-                                                                 0, vertices.size(), false);
+                                                                 0, vertices.size(), firstModifiedVertex, false);
 
     ChunkMemoryRange indexRangeToUse = getAvailableMemoryRange(occupiedIndexRanges, freeIndexRanges, chunkID,
-                                                               vertexRangeToUse.startPos, indices.size(), true);
+                                                               vertexRangeToUse.startPos, indices.size(),
+                                                               firstModifiedIndex, true);
 
-    std::copy(vertices.begin(), vertices.end(), globalChunkVertices.begin() + vertexRangeToUse.startPos);
-    std::copy(indices.begin(), indices.end(), globalChunkIndices.begin() + indexRangeToUse.startPos);
+    const uint32_t vertexCopyStart = std::min<uint32_t>(vertexRangeToUse.unsavedStart, vertices.size());
+    const uint32_t indexCopyStart = std::min<uint32_t>(indexRangeToUse.unsavedStart, indices.size());
+    std::copy(vertices.begin() + vertexCopyStart, vertices.end(),
+              globalChunkVertices.begin() + vertexRangeToUse.startPos + vertexCopyStart);
+    std::copy(indices.begin() + indexCopyStart, indices.end(),
+              globalChunkIndices.begin() + indexRangeToUse.startPos + indexCopyStart);
 
     newUpdate = true;
 }
 
+void VertexPool::removeFromVertexPool(const uint32_t chunkID) {
+    if (!occupiedVertexRanges.contains(chunkID)) {
+        return;
+    }
+
+    releaseMemoryRange(occupiedVertexRanges, freeVertexRanges, chunkID);
+    releaseMemoryRange(occupiedIndexRanges, freeIndexRanges, chunkID);
+    newUpdate = true;
+}
+
 std::unordered_map<uint32_t, ChunkMemoryRange> &VertexPool::getOccupiedVertexRanges() {
     return occupiedVertexRanges;
 }
@@ -33,23 +51,30 @@ std::unordered_map<uint32_t, ChunkMemoryRange> &VertexPool::getOccupiedIndexRang
     return occupiedIndexRanges;
 }
 
+void VertexPool::releaseMemoryRange(std::unordered_map<uint32_t, ChunkMemoryRange> &occupiedRanges,
+                                    std::vector<ChunkMemoryRange> &freeMemoryRanges, const uint32_t chunkID) {
+    if (const auto it = occupiedRanges.find(chunkID); it != occupiedRanges.end()) {
+        freeMemoryRanges.push_back(it->second);
+        occupiedRanges.erase(it);
+    }
+}
+
 ChunkMemoryRange VertexPool::getAvailableMemoryRange(std::unordered_map<uint32_t, ChunkMemoryRange> &occupiedRanges,
                                                      std::vector<ChunkMemoryRange> &freeMemoryRanges, uint32_t chunkID,
-                                                     uint32_t offset, const uint16_t objectCount,
-                                                     const bool poolType) {
-    const auto requiredObjects = *std::lower_bound(powersOfTwo.begin(), powersOfTwo.end(), objectCount);
+                                                     uint32_t offset, const uint32_t objectCount,
+                                                     const uint32_t firstModified, const bool poolType) {
+    const uint32_t requiredObjects = std::bit_ceil(std::max(objectCount, MIN_MEMORY_RANGE_SIZE));
     // if the chunk has already been allocated memory, and it is enough space to save the new mesh, save it
     // otherwise, free up the chunk's occupied range and move on
     if (occupiedRanges.contains(chunkID)) {
         ChunkMemoryRange &occupiedRange = occupiedRanges.at(chunkID);
 
         if (occupiedRange.endPos - occupiedRange.startPos >= requiredObjects) {
-            initMemoryRangeInfo(occupiedRange, poolType, offset, objectCount);
+            initMemoryRangeInfo(occupiedRange, poolType, offset, objectCount, firstModified);
             return occupiedRange;
         }
 
-        freeMemoryRanges.push_back(occupiedRange);
-        occupiedRanges.erase(chunkID);
+        releaseMemoryRange(occupiedRanges, freeMemoryRanges, chunkID);
     }
 
     // look for a suitable existing range with the correct size
@@ -89,16 +114,21 @@ ChunkMemoryRange VertexPool::getAvailableMemoryRange(std::unordered_map<uint32_t
         rangeToUse = splitUpAvailableMemory(freeMemoryRanges, &resizedRange, requiredObjects);
     }
 
-    initMemoryRangeInfo(rangeToUse, poolType, offset, objectCount);
+    // a new range has none of the chunk's mesh yet
+    initMemoryRangeInfo(rangeToUse, poolType, offset, objectCount, 0);
     occupiedRanges[chunkID] = rangeToUse;
     return rangeToUse;
 }
 
+// a range that hasn't been uploaded since its last change keeps the earlier start of that change
 void VertexPool::initMemoryRangeInfo(ChunkMemoryRange &rangeToUse, bool poolType, uint32_t offset,
-                                     uint32_t objectCount) {
+                                     uint32_t objectCount, const uint32_t firstModified) {
     if (poolType) {
         rangeToUse.offset = offset;
     }
+    rangeToUse.unsavedStart = rangeToUse.savedToVBuffer
+                                  ? firstModified
+                                  : std::min(rangeToUse.unsavedStart, firstModified);
     rangeToUse.objectCount = objectCount;
     rangeToUse.savedToVBuffer = false;
 }
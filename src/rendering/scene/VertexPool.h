@@ -5,12 +5,13 @@
 #include <vector>
 
 #include "Vertex.h"
+#include "../../core/ChunkGeometry.h"
 
 constexpr size_t VERTEX_SIZE = sizeof(ChunkVertex);
-const static std::vector<uint32_t> powersOfTwo = {64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768};
+constexpr uint32_t MIN_MEMORY_RANGE_SIZE = 64;
 
-static constexpr size_t CHUNK_VERTICES_SIZE = (8 * 8 * 8) * 8;
-static constexpr size_t CHUNK_INDICES_SIZE = (8 * 8 * 8) * 64; //there are 36 indices but we round up to 64
+static constexpr size_t CHUNK_VERTICES_SIZE = CHUNK_BLOCK_COUNT * 16; //a checkerboard needs 12 per block, round up to 16
+static constexpr size_t CHUNK_INDICES_SIZE = CHUNK_BLOCK_COUNT * 64; //there are 36 indices but we round up to 64
 
 extern std::vector<ChunkVertex> globalChunkVertices;
 extern std::vector<uint32_t> globalChunkIndices;
@@ -18,17 +19,24 @@ extern std::vector<uint32_t> globalChunkIndices;
 struct ChunkMemoryRange {
     uint32_t startPos;
     uint32_t endPos;
-    uint32_t offset;
-    uint16_t objectCount;
-    bool savedToVBuffer;
+    uint32_t offset = 0;
+    uint32_t objectCount = 0;
+    bool savedToVBuffer = false;
+    // objects before this one are already in the vertex buffer and don't have to be uploaded again
+    uint32_t unsavedStart = 0;
 };
 
 class VertexPool {
 public:
     static bool newUpdate;
 
+    // if the chunk keeps its ranges only the vertices and indices from firstModifiedVertex and firstModifiedIndex
+    // on are copied and uploaded, the ones before them must be the same as in the chunk's last mesh
     static void addToVertexPool(const std::vector<ChunkVertex> &vertices, const std::vector<uint32_t> &indices,
-                                uint32_t chunkID);
+                                uint32_t chunkID, uint32_t firstModifiedVertex = 0, uint32_t firstModifiedIndex = 0);
+
+    // hands the chunk's ranges back to the free lists, does nothing if it has none
+    static void removeFromVertexPool(uint32_t chunkID);
 
     static std::unordered_map<uint32_t, ChunkMemoryRange> &getOccupiedVertexRanges();
 
@@ -40,12 +48,16 @@ private:
     static std::vector<ChunkMemoryRange> freeVertexRanges;
     static std::vector<ChunkMemoryRange> freeIndexRanges;
 
+    static void releaseMemoryRange(std::unordered_map<uint32_t, ChunkMemoryRange> &occupiedRanges,
+                                   std::vector<ChunkMemoryRange> &freeMemoryRanges, uint32_t chunkID);
+
     static ChunkMemoryRange getAvailableMemoryRange(std::unordered_map<uint32_t, ChunkMemoryRange> &occupiedRanges,
                                                     std::vector<ChunkMemoryRange> &freeMemoryRanges, uint32_t chunkID,
-                                                    uint32_t offset, uint16_t objectCount,
-                                                    bool poolType);
+                                                    uint32_t offset, uint32_t objectCount,
+                                                    uint32_t firstModified, bool poolType);
 
-    static void initMemoryRangeInfo(ChunkMemoryRange &rangeToUse, bool poolType, uint32_t offset, uint32_t objectCount);
+    static void initMemoryRangeInfo(ChunkMemoryRange &rangeToUse, bool poolType, uint32_t offset, uint32_t objectCount,
+                                    uint32_t firstModified);
 
     static ChunkMemoryRange splitUpAvailableMemory(std::vector<ChunkMemoryRange> &freeMemoryRanges,
                                                    const ChunkMemoryRange *rangeToSplit, uint32_t requiredSpace);
@@ -1,6 +1,8 @@
-#include "Vertex.h"
+#include "VertexLayout.h"
 
-VkVertexInputBindingDescription ChunkVertex::getBindingDescription() {
+#include <cstddef>
+
+VkVertexInputBindingDescription ChunkVertexLayout::getBindingDescription() {
     VkVertexInputBindingDescription bindingDescription{};
     bindingDescription.binding = 0;
     bindingDescription.stride = sizeof(ChunkVertex);
@@ -9,7 +11,7 @@ VkVertexInputBindingDescription ChunkVertex::getBindingDescription() {
     return bindingDescription;
 }
 
-std::vector<VkVertexInputAttributeDescription> ChunkVertex::getAttributeDescriptions() {
+std::vector<VkVertexInputAttributeDescription> ChunkVertexLayout::getAttributeDescriptions() {
     std::vector<VkVertexInputAttributeDescription> attributeDescriptions(2);
     attributeDescriptions[0].binding = 0;
     attributeDescriptions[0].location = 0;
@@ -23,7 +25,7 @@ std::vector<VkVertexInputAttributeDescription> ChunkVertex::getAttributeDescript
     return attributeDescriptions;
 }
 
-VkVertexInputBindingDescription TexturedVertex::getBindingDescription() {
+VkVertexInputBindingDescription TexturedVertexLayout::getBindingDescription() {
     VkVertexInputBindingDescription bindingDescription{};
     bindingDescription.binding = 0;
     bindingDescription.stride = sizeof(TexturedVertex);
@@ -32,7 +34,7 @@ VkVertexInputBindingDescription TexturedVertex::getBindingDescription() {
     return bindingDescription;
 }
 
-std::vector<VkVertexInputAttributeDescription> TexturedVertex::getAttributeDescriptions() {
+std::vector<VkVertexInputAttributeDescription> TexturedVertexLayout::getAttributeDescriptions() {
     std::vector<VkVertexInputAttributeDescription> attributeDescriptions(3);
 
     attributeDescriptions[0].binding = 0;
@@ -0,0 +1,22 @@
+#ifndef VERTEXLAYOUT_H
+#define VERTEXLAYOUT_H
+
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "../scene/Vertex.h"
+
+// how the vertex structs are fed to the graphics pipelines, kept apart from them so the world code doesn't need Vulkan
+struct ChunkVertexLayout {
+    static VkVertexInputBindingDescription getBindingDescription();
+
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+};
+
+struct TexturedVertexLayout {
+    static VkVertexInputBindingDescription getBindingDescription();
+
+    static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+};
+
+#endif //VERTEXLAYOUT_H
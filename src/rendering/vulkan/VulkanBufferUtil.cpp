@@ -176,12 +176,16 @@ void copyBufferRanges(const VkBuffer &srcBuffer, const VkBuffer &dstBuffer, uint
     std::vector<VkBufferCopy> rangesToCopy;
     for (auto &[chunkID, memoryRange]: memoryRanges) {
         if (!memoryRange.savedToVBuffer) {
+            memoryRange.savedToVBuffer = true;
+            if (memoryRange.unsavedStart >= memoryRange.objectCount) {
+                continue;
+            }
+
             VkBufferCopy copyRegion{};
-            uint32_t startByte = memoryRange.startPos * objectSize;
+            uint32_t startByte = (memoryRange.startPos + memoryRange.unsavedStart) * objectSize;
             copyRegion.srcOffset = startByte;
             copyRegion.dstOffset = startByte;
-            copyRegion.size = memoryRange.objectCount * objectSize;
-            memoryRange.savedToVBuffer = true;
+            copyRegion.size = (memoryRange.objectCount - memoryRange.unsavedStart) * objectSize;
             vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
         }
     }
@@ -227,11 +231,11 @@ void updateChunkBuffer(const VkBuffer &buffer, const VkBuffer &stagingBuffer, co
 
     bool regionUpdateFound = false;
     for (auto &[chunkID, memoryRange]: memoryRanges) {
-        if (!memoryRange.savedToVBuffer) {
-            const uint32_t memoryOffset = memoryRange.startPos * objectSize;
+        if (!memoryRange.savedToVBuffer && memoryRange.unsavedStart < memoryRange.objectCount) {
+            const uint32_t memoryOffset = (memoryRange.startPos + memoryRange.unsavedStart) * objectSize;
             memcpy(static_cast<char *>(data) + memoryOffset,
                    static_cast<char *>(newData) + memoryOffset,
-                   memoryRange.objectCount * objectSize);
+                   (memoryRange.objectCount - memoryRange.unsavedStart) * objectSize);
             regionUpdateFound = true;
         }
     }
@@ -0,0 +1,53 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+
+#include "../core/ChunkManager.h"
+
+static bool check(const bool condition, const char *message) {
+    if (!condition) {
+        std::cerr << "raycast test failed: " << message << "\n";
+    }
+    return condition;
+}
+
+static bool hits(const std::optional<RaycastHit> &hit, const glm::ivec3 &blockPos, const glm::ivec3 &normal,
+                 const float distance) {
+    return hit.has_value() && hit->blockPos == blockPos && hit->normal == normal &&
+           std::abs(hit->distance - distance) < 1e-4f;
+}
+
+// block p is drawn as the cube from p - 0.5 to p + 0.5, so a ray has to hit that cube and nothing next to it
+int main() {
+    try {
+        const glm::ivec3 blockPos(5, 3, 2);
+        Block block{glm::vec3(blockPos), {}};
+        Block::setColor(block, 200, 100, 50);
+
+        ChunkManager chunkManager;
+        chunkManager.addBlock(block);
+
+        bool passed = true;
+        passed &= check(hits(chunkManager.raycast({5.4f, 3.0f, -3.0f}, {0.0f, 0.0f, 1.0f}, 64.0f), blockPos,
+                             {0, 0, -1}, 4.5f), "a ray along z misses the block's front face");
+        passed &= check(hits(chunkManager.raycast({4.6f, 3.0f, -3.0f}, {0.0f, 0.0f, 1.0f}, 64.0f), blockPos,
+                             {0, 0, -1}, 4.5f), "a ray just inside the block's left side misses it");
+        passed &= check(!chunkManager.raycast({5.6f, 3.0f, -3.0f}, {0.0f, 0.0f, 1.0f}, 64.0f).has_value(),
+                        "a ray just past the block's right side hits it");
+        passed &= check(!chunkManager.raycast({4.4f, 3.0f, -3.0f}, {0.0f, 0.0f, 1.0f}, 64.0f).has_value(),
+                        "a ray just past the block's left side hits it");
+        passed &= check(hits(chunkManager.raycast({5.2f, 10.0f, 2.3f}, {0.0f, -2.0f, 0.0f}, 64.0f), blockPos,
+                             {0, 1, 0}, 6.5f), "a ray straight down misses the block's top face");
+        passed &= check(hits(chunkManager.raycast({5.3f, 3.4f, 1.6f}, {1.0f, 1.0f, 1.0f}, 64.0f), blockPos,
+                             {0, 0, 0}, 0.0f), "a ray starting inside the block doesn't hit it at once");
+        passed &= check(!chunkManager.raycast({5.0f, 3.0f, -3.0f}, {0.0f, 0.0f, 1.0f}, 4.0f).has_value(),
+                        "a ray hits the block beyond its maximum distance");
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,94 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "../core/StartupCache.h"
+
+static const StartupCacheKey CACHE_KEY = {1, 2, 3, 0.01f, 16, 20, 0, 0};
+
+static bool check(const bool condition, const char *message) {
+    if (!condition) {
+        std::cerr << "startup cache test failed: " << message << "\n";
+    }
+    return condition;
+}
+
+static std::vector<char> readFile(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator(file), std::istreambuf_iterator<char>()};
+}
+
+static void writeFile(const std::filesystem::path &path, const std::vector<char> &data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// a broken cache must be turned down before any chunk is created, otherwise the caller would generate the startup
+// terrain over a half restored map
+static bool loadsNothing(const StartupCache &cache) {
+    ChunkManager chunkManager;
+    return !cache.load(chunkManager, CACHE_KEY) && chunkManager.chunkCount() == 0;
+}
+
+// saves a few meshed chunks, then loads the cache back whole, cut off at every length and with its second half
+// overwritten, and into a chunk manager that already has one of its chunks
+int main() {
+    try {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "voxel_startup_cache_test.bin";
+        const StartupCache cache(path);
+
+        ChunkManager savedChunks;
+        std::vector<Block> blocks;
+        for (int x = -CHUNK_EDGE; x < CHUNK_EDGE * 2; x += 3) {
+            for (int z = 0; z < CHUNK_EDGE; z += 2) {
+                Block block{glm::vec3(x, x & 3, z), {}};
+                Block::setColor(block, static_cast<uint8_t>(x * 10), 120, static_cast<uint8_t>(z * 20));
+                blocks.push_back(block);
+            }
+        }
+        savedChunks.addBlocks(blocks);
+        savedChunks.meshAllChunks();
+        cache.save(savedChunks, CACHE_KEY);
+
+        bool passed = true;
+        {
+            ChunkManager loadedChunks;
+            passed &= check(cache.load(loadedChunks, CACHE_KEY), "the saved cache doesn't load");
+            passed &= check(loadedChunks.chunkCount() == savedChunks.chunkCount(), "chunks are missing after loading");
+            for (const Block &block: blocks) {
+                passed &= check(loadedChunks.hasBlock(block.position), "a saved block is missing after loading");
+            }
+        }
+
+        {
+            ChunkManager loadedChunks;
+            loadedChunks.createChunk(savedChunks.chunks.begin()->first);
+            passed &= check(!cache.load(loadedChunks, CACHE_KEY) && loadedChunks.chunkCount() == 1,
+                            "a cache holding a chunk that already exists was loaded");
+        }
+
+        const std::vector<char> cacheData = readFile(path);
+        for (size_t size = 0; size < cacheData.size(); size++) {
+            writeFile(path, std::vector(cacheData.begin(), cacheData.begin() + static_cast<std::ptrdiff_t>(size)));
+            if (!check(loadsNothing(cache), "a truncated cache was loaded")) {
+                passed = false;
+                break;
+            }
+        }
+
+        std::vector<char> corruptData = cacheData;
+        std::fill(corruptData.begin() + static_cast<std::ptrdiff_t>(corruptData.size() / 2), corruptData.end(), '\xff');
+        writeFile(path, corruptData);
+        passed &= check(loadsNothing(cache), "a corrupted cache was loaded");
+
+        std::filesystem::remove(path);
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef BYTEUTIL_H
+#define BYTEUTIL_H
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// helpers for the binary save files, values are copied as they are in memory so they are read back by the same build
+
+template<typename T>
+void appendValue(std::vector<std::byte> &data, const T &value) {
+    const size_t offset = data.size();
+    data.resize(offset + sizeof(T));
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+template<typename T>
+void appendValues(std::vector<std::byte> &data, const std::span<const T> values) {
+    const auto bytes = std::as_bytes(values);
+    data.insert(data.end(), bytes.begin(), bytes.end());
+}
+
+// data is only trusted as far as its own sizes go, anything reaching past the end is a broken file
+template<typename T>
+T readValue(const std::span<const std::byte> data, size_t &offset) {
+    if (offset + sizeof(T) > data.size()) {
+        throw std::runtime_error("save file error: record is truncated!");
+    }
+
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+#endif //BYTEUTIL_H
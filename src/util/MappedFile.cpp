@@ -0,0 +1,112 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the file handles are only needed to create the mapping, which keeps the file open on its own
+MappedFile::MappedFile(const std::filesystem::path &path) {
+#ifdef _WIN32
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("mapped file error: failed to open " + path.string() + "!");
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::runtime_error("mapped file error: failed to read the size of " + path.string() + "!");
+    }
+
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    if (mappedSize == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        throw std::runtime_error("mapped file error: failed to map " + path.string() + "!");
+    }
+
+    mappedData = static_cast<const std::byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (mappedData == nullptr) {
+        throw std::runtime_error("mapped file error: failed to map " + path.string() + "!");
+    }
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("mapped file error: failed to open " + path.string() + "!");
+    }
+
+    struct stat fileInfo{};
+    if (fstat(file, &fileInfo) != 0) {
+        close(file);
+        throw std::runtime_error("mapped file error: failed to read the size of " + path.string() + "!");
+    }
+
+    mappedSize = static_cast<size_t>(fileInfo.st_size);
+    if (mappedSize == 0) {
+        close(file);
+        return;
+    }
+
+    void *mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("mapped file error: failed to map " + path.string() + "!");
+    }
+    mappedData = static_cast<const std::byte *>(mapping);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : mappedData(std::exchange(other.mappedData, nullptr)), mappedSize(std::exchange(other.mappedSize, 0)) {
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        mappedData = std::exchange(other.mappedData, nullptr);
+        mappedSize = std::exchange(other.mappedSize, 0);
+    }
+    return *this;
+}
+
+const std::byte *MappedFile::data() const {
+    return mappedData;
+}
+
+size_t MappedFile::size() const {
+    return mappedSize;
+}
+
+void MappedFile::unmap() {
+    if (mappedData == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData);
+#else
+    munmap(const_cast<std::byte *>(mappedData), mappedSize);
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+
+// a whole file mapped read-only into memory, reads are served straight from the page cache
+class MappedFile {
+public:
+    // throws if the file can't be opened or mapped, an empty file maps to a null pointer and a size of 0
+    explicit MappedFile(const std::filesystem::path &path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    [[nodiscard]] const std::byte *data() const;
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    const std::byte *mappedData = nullptr;
+    size_t mappedSize = 0;
+
+    void unmap();
+};
+
+#endif //MAPPEDFILE_H
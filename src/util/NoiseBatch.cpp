@@ -0,0 +1,140 @@
+#include "NoiseBatch.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+static constexpr uint32_t PRIME_X = 501125321;
+static constexpr uint32_t PRIME_Y = 1136930381;
+static constexpr uint32_t HASH_MULTIPLIER = 0x27d4eb2d;
+
+static constexpr float SQRT3 = 1.7320508075688772935274463415059f;
+static constexpr float F2 = 0.5f * (SQRT3 - 1);
+static constexpr float G2 = (3 - SQRT3) / 6;
+static constexpr float FAR_CORNER_T = 2 * (1 - 2 * G2) * (1 / G2 - 2);
+static constexpr float FAR_CORNER_BASE = -2 * (1 - 2 * G2) * (1 - 2 * G2);
+static constexpr float NOISE_SCALE = 99.83685446303647f;
+
+// the same 128 gradients FastNoiseLite hashes into: 24 directions repeated five times, then 8 more
+static std::array<float, 256> createGradientTable() {
+    constexpr float directions[48] = {
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f,
+        0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f,
+        0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f,
+        0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f,
+        -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f,
+        -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f,
+        -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+    };
+    constexpr float diagonals[16] = {
+        0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f,
+        0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+        -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f,
+        -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+    };
+
+    std::array<float, 256> gradients{};
+    for (int i = 0; i < 5; i++) {
+        std::memcpy(gradients.data() + i * 48, directions, sizeof(directions));
+    }
+    std::memcpy(gradients.data() + 240, diagonals, sizeof(diagonals));
+    return gradients;
+}
+
+static const std::array<float, 256> gradients = createGradientTable();
+
+// FastNoiseLite's hash is signed, but only bits 1-7 survive the mask so unsigned math gives the same index
+static uint32_t gradientIndex(const uint32_t seed, const uint32_t xPrimed, const uint32_t yPrimed) {
+    const uint32_t hash = (seed ^ xPrimed ^ yPrimed) * HASH_MULTIPLIER;
+    return (hash ^ (hash >> 15)) & 254;
+}
+
+NoiseBatch::NoiseBatch(const int seed, const float frequency) : seed(seed), frequency(frequency) {
+}
+
+// the grid is split into blocks of LANES samples, and each block goes through three passes over plain arrays: the
+// lattice math and hashing, the gradient lookups, then the falloffs. blocks run across rows so a narrow grid still
+// fills every lane. the first and last passes are straight-line float and integer math, so they vectorize even
+// where gathers are slow or missing
+void NoiseBatch::sampleGrid(const int minX, const int minZ, const int width, const int depth, float *out) const {
+    const auto hashSeed = static_cast<uint32_t>(seed);
+    const int sampleCount = width * depth;
+
+    float sampleX[LANES], sampleZ[LANES];
+    float x0[LANES], y0[LANES], x1[LANES], y1[LANES];
+    float a[LANES], b[LANES], c[LANES];
+    uint32_t gradient0[LANES], gradient1[LANES], gradient2[LANES];
+    float dot0[LANES], dot1[LANES], dot2[LANES];
+    float noise[LANES];
+
+    int x = 0;
+    int z = 0;
+    for (int blockStart = 0; blockStart < sampleCount; blockStart += LANES) {
+        // lanes past the end of the grid sample the next row down and are never written out
+        for (int lane = 0; lane < LANES; lane++) {
+            sampleX[lane] = static_cast<float>(minX + x) * frequency;
+            sampleZ[lane] = static_cast<float>(minZ + z) * frequency;
+            if (++x == width) {
+                x = 0;
+                z++;
+            }
+        }
+
+        for (int lane = 0; lane < LANES; lane++) {
+            const float skew = (sampleX[lane] + sampleZ[lane]) * F2;
+            const float skewedX = sampleX[lane] + skew;
+            const float skewedY = sampleZ[lane] + skew;
+
+            // FastNoiseLite's floor rounds negative whole numbers down by one as well, keep that
+            const int cellX = static_cast<int>(skewedX) - (skewedX < 0);
+            const int cellY = static_cast<int>(skewedY) - (skewedY < 0);
+
+            const float xi = skewedX - static_cast<float>(cellX);
+            const float yi = skewedY - static_cast<float>(cellY);
+            const float t = (xi + yi) * G2;
+            x0[lane] = xi - t;
+            y0[lane] = yi - t;
+            a[lane] = 0.5f - x0[lane] * x0[lane] - y0[lane] * y0[lane];
+            c[lane] = FAR_CORNER_T * t + (FAR_CORNER_BASE + a[lane]);
+
+            // the middle corner is one step along whichever skewed axis is further from the cell origin
+            const bool upperTriangle = y0[lane] > x0[lane];
+            x1[lane] = x0[lane] + (upperTriangle ? G2 : G2 - 1);
+            y1[lane] = y0[lane] + (upperTriangle ? G2 - 1 : G2);
+            b[lane] = 0.5f - x1[lane] * x1[lane] - y1[lane] * y1[lane];
+
+            const uint32_t primedX = static_cast<uint32_t>(cellX) * PRIME_X;
+            const uint32_t primedY = static_cast<uint32_t>(cellY) * PRIME_Y;
+            gradient0[lane] = gradientIndex(hashSeed, primedX, primedY);
+            gradient1[lane] = gradientIndex(hashSeed, upperTriangle ? primedX : primedX + PRIME_X,
+                                            upperTriangle ? primedY + PRIME_Y : primedY);
+            gradient2[lane] = gradientIndex(hashSeed, primedX + PRIME_X, primedY + PRIME_Y);
+        }
+
+        for (int lane = 0; lane < LANES; lane++) {
+            dot0[lane] = x0[lane] * gradients[gradient0[lane]] + y0[lane] * gradients[gradient0[lane] | 1];
+            dot1[lane] = x1[lane] * gradients[gradient1[lane]] + y1[lane] * gradients[gradient1[lane] | 1];
+            const float x2 = x0[lane] + (2 * G2 - 1);
+            const float y2 = y0[lane] + (2 * G2 - 1);
+            dot2[lane] = x2 * gradients[gradient2[lane]] + y2 * gradients[gradient2[lane] | 1];
+        }
+
+        // corners outside their radius are selected away instead of branched on, they add exactly 0 either way
+        for (int lane = 0; lane < LANES; lane++) {
+            const float n0 = (a[lane] * a[lane]) * (a[lane] * a[lane]) * dot0[lane];
+            const float n1 = (b[lane] * b[lane]) * (b[lane] * b[lane]) * dot1[lane];
+            const float n2 = (c[lane] * c[lane]) * (c[lane] * c[lane]) * dot2[lane];
+            noise[lane] = ((a[lane] > 0 ? n0 : 0.0f) + (b[lane] > 0 ? n1 : 0.0f) + (c[lane] > 0 ? n2 : 0.0f)) *
+                          NOISE_SCALE;
+        }
+
+        const int laneCount = std::min(LANES, sampleCount - blockStart);
+        std::copy_n(noise, laneCount, out + blockStart);
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef NOISEBATCH_H
+#define NOISEBATCH_H
+
+#include <cstring>
+
+#include <FastNoiseLite.h>
+
+// evaluates FastNoiseLite's 2D OpenSimplex2 over a whole grid of integer coordinates at once
+// samples are worked on in fixed blocks of lanes so the compiler can run them across SIMD registers. every step is
+// done in the same order and precision as FastNoiseLite::GetNoise, so the results are bit-identical as long as
+// neither side is built with fused multiply-adds, which round differently. NoiseBatch.cpp never contracts, and
+// if the scalar side does matches() reports it
+class NoiseBatch {
+public:
+    NoiseBatch(int seed, float frequency);
+
+    // fills out[z * width + x] with the noise at (minX + x, minZ + z)
+    void sampleGrid(int minX, int minZ, int width, int depth, float *out) const;
+
+    // compares a spread of probe points against the scalar generator, callers should fall back to GetNoise when
+    // this fails. it is inline so GetNoise is compiled with the caller's flags, which is what can make them differ
+    [[nodiscard]] bool matches(const FastNoiseLite &noise) const;
+
+private:
+    static constexpr int LANES = 16;
+
+    int seed;
+    float frequency;
+};
+
+// probes both sides of the origin and coordinates far enough out for the skew to round
+inline bool NoiseBatch::matches(const FastNoiseLite &noise) const {
+    constexpr int probeMin[4] = {-4096, -300, 0, 70000};
+    constexpr int probeSize = 16;
+    float batchValues[probeSize * probeSize];
+
+    for (const int minX: probeMin) {
+        for (const int minZ: probeMin) {
+            sampleGrid(minX, minZ, probeSize, probeSize, batchValues);
+
+            for (int z = 0; z < probeSize; z++) {
+                for (int x = 0; x < probeSize; x++) {
+                    const float scalarValue = noise.GetNoise(static_cast<float>(minX + x),
+                                                             static_cast<float>(minZ + z));
+                    if (std::memcmp(&scalarValue, &batchValues[z * probeSize + x], sizeof(float)) != 0) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif //NOISEBATCH_H
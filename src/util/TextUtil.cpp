@@ -1,5 +1,8 @@
 #include "TextUtil.h"
 
+#include <cstdint>
+#include <sstream>
+
 template <typename T>
 std::string TextUtil::getCommaString(const T& num) {
     std::stringstream ss;
@@ -10,5 +13,6 @@ std::string TextUtil::getCommaString(const T& num) {
 }
 
 template std::string TextUtil::getCommaString<unsigned int>(const unsigned int&);
+template std::string TextUtil::getCommaString<uint64_t>(const uint64_t&);
 
 
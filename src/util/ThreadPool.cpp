@@ -0,0 +1,134 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef VOXEL_WORKER_THREADS
+unsigned ThreadPool::threadCount = VOXEL_WORKER_THREADS;
+#else
+unsigned ThreadPool::threadCount = 0;
+#endif
+
+std::mutex ThreadPool::mutex;
+std::condition_variable_any ThreadPool::jobReady;
+std::condition_variable ThreadPool::jobDone;
+
+const std::function<void(size_t)> *ThreadPool::currentJob = nullptr;
+size_t ThreadPool::jobSize = 0;
+std::atomic<size_t> ThreadPool::nextIndex = 0;
+uint64_t ThreadPool::jobGeneration = 0;
+unsigned ThreadPool::busyWorkers = 0;
+std::exception_ptr ThreadPool::jobError;
+
+// defined last so the workers are stopped and joined before anything they use is destroyed
+std::vector<std::jthread> ThreadPool::workers;
+thread_local unsigned ThreadPool::threadIndex = 0;
+
+void ThreadPool::setThreadCount(const unsigned threadCount) {
+    workers.clear();
+    ThreadPool::threadCount = threadCount;
+}
+
+unsigned ThreadPool::getThreadCount() {
+    if (threadCount == 0) {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return threadCount;
+}
+
+void ThreadPool::parallelFor(const size_t count, const std::function<void(size_t)> &job) {
+    if (workers.empty()) {
+        startWorkers();
+    }
+
+    if (workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        currentJob = &job;
+        jobSize = count;
+        nextIndex = 0;
+        busyWorkers = workers.size();
+        jobError = nullptr;
+        jobGeneration++;
+    }
+    jobReady.notify_all();
+
+    try {
+        runJob(job, count);
+    }
+    catch (...) {
+        std::lock_guard lock(mutex);
+        if (!jobError) {
+            jobError = std::current_exception();
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    jobDone.wait(lock, [] { return busyWorkers == 0; });
+    currentJob = nullptr;
+
+    if (jobError) {
+        std::rethrow_exception(std::exchange(jobError, nullptr));
+    }
+}
+
+unsigned ThreadPool::getThreadIndex() {
+    return threadIndex;
+}
+
+void ThreadPool::startWorkers() {
+    const unsigned workerCount = getThreadCount() - 1;
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; i++) {
+        workers.emplace_back(workerLoop, i + 1, jobGeneration);
+    }
+}
+
+// the generation is passed in rather than read here, since a job may already be posted once the thread is running
+void ThreadPool::workerLoop(const std::stop_token &stopToken, const unsigned workerIndex,
+                            uint64_t finishedGeneration) {
+    threadIndex = workerIndex;
+
+    while (true) {
+        const std::function<void(size_t)> *job;
+        size_t count;
+        {
+            std::unique_lock lock(mutex);
+            if (!jobReady.wait(lock, stopToken, [&] { return jobGeneration != finishedGeneration; })) {
+                return;
+            }
+            finishedGeneration = jobGeneration;
+            job = currentJob;
+            count = jobSize;
+        }
+
+        std::exception_ptr error;
+        try {
+            runJob(*job, count);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard lock(mutex);
+        if (error && !jobError) {
+            jobError = error;
+        }
+        if (--busyWorkers == 0) {
+            jobDone.notify_one();
+        }
+    }
+}
+
+// threads take one index at a time, so uneven jobs still end up balanced
+void ThreadPool::runJob(const std::function<void(size_t)> &job, const size_t count) {
+    for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+        job(i);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// a fixed set of worker threads that split loops between them, the calling thread helps out as well
+// jobs may only read shared state, anything that isn't thread safe (like the vertex pool) is done by the caller after
+class ThreadPool {
+public:
+    // the number of threads a loop is spread over, including the caller. 0 means one per core
+    static void setThreadCount(unsigned threadCount);
+
+    static unsigned getThreadCount();
+
+    // calls job(i) for every i below count and returns once all of them have finished
+    // the first exception thrown by a job is rethrown here
+    static void parallelFor(size_t count, const std::function<void(size_t)> &job);
+
+    // 0 on the thread that calls parallelFor, 1 and up on the workers, for keeping per-thread results
+    static unsigned getThreadIndex();
+
+private:
+    static unsigned threadCount;
+
+    static std::mutex mutex;
+    static std::condition_variable_any jobReady;
+    static std::condition_variable jobDone;
+
+    static const std::function<void(size_t)> *currentJob;
+    static size_t jobSize;
+    static std::atomic<size_t> nextIndex;
+    static uint64_t jobGeneration;
+    static unsigned busyWorkers;
+    static std::exception_ptr jobError;
+
+    static std::vector<std::jthread> workers;
+    static thread_local unsigned threadIndex;
+
+    static void startWorkers();
+
+    static void workerLoop(const std::stop_token &stopToken, unsigned workerIndex, uint64_t finishedGeneration);
+
+    static void runJob(const std::function<void(size_t)> &job, size_t count);
+};
+
+#endif //THREADPOOL_H
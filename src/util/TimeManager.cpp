@@ -1,14 +1,18 @@
 #include "TimeManager.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
+#include "TextUtil.h"
+
 std::chrono::time_point<std::chrono::high_resolution_clock> TimeManager::lastFrameTime =
     std::chrono::high_resolution_clock::now();
 float TimeManager::deltaTime;
 
 std::map<std::string, std::chrono::time_point<std::chrono::high_resolution_clock>> TimeManager::timers;
 std::map<std::string, TimeProfiler> TimeManager::profilers;
+std::map<std::string, uint64_t> TimeManager::counters;
 
 std::vector<float> TimeManager::frameTimes;
 float TimeManager::timeBetweenDisplay = 0.25f;
@@ -64,6 +68,10 @@ float TimeManager::finishProfiler(const std::string& name) {
     return profilerTime;
 }
 
+void TimeManager::addCountToProfiler(const std::string& name, const uint64_t count) {
+    counters[name] += count;
+}
+
 void TimeManager::printAllProfiling() {
     std::cout << "Profiling results:\n";
 
@@ -79,6 +87,10 @@ void TimeManager::printAllProfiling() {
         totalTime += profiler.getTotalTime();
     }
     std::cout << "Total time: " << totalTime << " seconds\n";
+
+    for (auto&[counterName, count] : counters) {
+        std::cout << counterName << ": " << TextUtil::getCommaString(count) << "\n";
+    }
 }
 
 float TimeManager::queryFPS() {
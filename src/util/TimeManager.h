@@ -2,6 +2,7 @@
 #define TIMEMANAGER_H
 
 #include <chrono>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -23,6 +24,7 @@ public:
 
     static void addTimeToProfiler(const std::string& name, float time);
     static float finishProfiler(const std::string& name);
+    static void addCountToProfiler(const std::string& name, uint64_t count);
     static void printAllProfiling();
 
     static float queryFPS();
@@ -33,6 +35,7 @@ private:
 
     static std::map<std::string, std::chrono::time_point<std::chrono::high_resolution_clock>> timers;
     static std::map<std::string, TimeProfiler> profilers;
+    static std::map<std::string, uint64_t> counters;
 
     static std::vector<float> frameTimes;
     static float timeBetweenDisplay;
@@ -2,41 +2,46 @@
 
 #include "../rendering/scene/Vertex.h"
 
-void insertBlockVertices(std::vector<ChunkVertex> &chunkVertices, std::array<bool, 6> &facesToDraw,
-                         glm::vec3 &blockPos, uint8_t color[4]) {
-    const std::array<glm::vec3, 8> positions = {
+void insertBlockFace(std::vector<ChunkVertex> &chunkVertices, std::vector<uint32_t> &chunkIndices, const int face,
+                     const glm::vec3 &blockPos, const uint8_t color[4], const glm::vec3 &faceSize) {
+    static const std::array<glm::vec3, 8> positions = {
         {
             {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
             {0.5f, -0.5f, 0.5f}, {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, -0.5f}, {-0.5f, -0.5f, -0.5f}
         }
     };
 
-    for (const auto &pos: positions) {
+    // corners of each face, the quad is split along the diagonal from its second to its third corner
+    static constexpr std::array<uint32_t, 4> faceCorners[6] = {
+        {0, 2, 1, 3}, // top
+        {7, 6, 5, 4}, // bottom
+        {1, 5, 0, 4}, // front
+        {3, 2, 7, 6}, // back
+        {7, 5, 3, 1}, // left
+        {0, 4, 2, 6} // right
+    };
+
+    // corners on the far side of the block are moved out to the far side of the quad
+    const glm::vec3 quadCorner = blockPos - 0.5f;
+    const auto startIndex = static_cast<uint32_t>(chunkVertices.size());
+    for (const uint32_t corner: faceCorners[face]) {
         ChunkVertex newVertex = {
-            pos + blockPos,
+            quadCorner + (positions[corner] + 0.5f) * faceSize,
             color[0],
             color[1],
             color[2]
         };
         chunkVertices.push_back(newVertex);
     }
+
+    insertQuadIndices(chunkIndices, startIndex);
 }
 
-void insertBlockIndices(std::vector<uint32_t> &chunkIndices, std::array<bool, 6> &facesToDraw, uint32_t startIndex) {
-    const std::array<uint32_t, 6> newIndices[6] = {
-        {startIndex + 0, startIndex + 2, startIndex + 1, startIndex + 3, startIndex + 1, startIndex + 2}, // top
-        {startIndex + 7, startIndex + 6, startIndex + 5, startIndex + 4, startIndex + 5, startIndex + 6}, // bottom
-        {startIndex + 1, startIndex + 5, startIndex + 0, startIndex + 4, startIndex + 0, startIndex + 5}, // front
-        {startIndex + 3, startIndex + 2, startIndex + 7, startIndex + 6, startIndex + 7, startIndex + 2}, // back
-        {startIndex + 7, startIndex + 5, startIndex + 3, startIndex + 1, startIndex + 3, startIndex + 5}, // left
-        {startIndex + 0, startIndex + 4, startIndex + 2, startIndex + 6, startIndex + 2, startIndex + 4} // right
+void insertQuadIndices(std::vector<uint32_t> &chunkIndices, const uint32_t firstVertex) {
+    const std::array<uint32_t, 6> newIndices = {
+        firstVertex + 0, firstVertex + 1, firstVertex + 2, firstVertex + 3, firstVertex + 2, firstVertex + 1
     };
-
-    for (size_t i = 0; i < 6; i++) {
-        if (facesToDraw[i]) {
-            chunkIndices.insert(chunkIndices.end(), newIndices[i].begin(), newIndices[i].end());
-        }
-    }
+    chunkIndices.insert(chunkIndices.end(), newIndices.begin(), newIndices.end());
 }
 
 std::vector<TexturedVertex> generateTexturedQuad(glm::vec4 quadBounds, glm::vec4 texQuadBounds, glm::vec2 startPos) {
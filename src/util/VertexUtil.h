@@ -6,11 +6,14 @@
 
 #include "../rendering/scene/Vertex.h"
 
-extern void insertBlockVertices(std::vector<ChunkVertex> &chunkVertices, std::array<bool, 6> &facesToDraw,
-                                glm::vec3 &blockPos, uint8_t color[4]);
+// face is one of top, bottom, front, back, left, right
+// the quad starts at the block at blockPos and is stretched to cover faceSize blocks along each axis
+extern void insertBlockFace(std::vector<ChunkVertex> &chunkVertices, std::vector<uint32_t> &chunkIndices, int face,
+                            const glm::vec3 &blockPos, const uint8_t color[4],
+                            const glm::vec3 &faceSize = glm::vec3(1.0f));
 
-extern void insertBlockIndices(std::vector<uint32_t> &chunkIndices, std::array<bool, 6> &facesToDraw,
-                               uint32_t startIndex);
+// the two triangles of the quad whose four vertices start at firstVertex
+extern void insertQuadIndices(std::vector<uint32_t> &chunkIndices, uint32_t firstVertex);
 
 extern std::vector<TexturedVertex> generateTexturedQuad(glm::vec4 quadBounds, glm::vec4 texQuadBounds,
                                                         glm::vec2 startPos);